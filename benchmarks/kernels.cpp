@@ -0,0 +1,224 @@
+#include "ASP.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Micro-benchmarks of the hot paths (neighborhoods, RVND, constructions and perturbations) on every instance of
+// data/instances and data/copa_instances. Each run starts from the same seeded solution, restored out of the timed
+// region, so that a change of the timings comes from the code and not from the search. Restoring it pauses the timer,
+// which costs a few hundred nanoseconds: timings below a microsecond are mostly that overhead.
+//
+//   asp_benchmarks [data directory] [--benchmark_filter=<regex>] [other Google Benchmark flags]
+
+#ifndef ASP_DATA_DIR
+#define ASP_DATA_DIR "data"
+#endif
+
+namespace {
+
+constexpr uint64_t SEED = 42;
+
+// Moves scanned by a best improvement neighborhood from solution, as its loops enumerate them
+using MoveCount = size_t (*)(const Solution &solution);
+
+size_t intra_swap_moves(const Solution &solution) {
+    size_t moves = 0;
+    for (const Runway &runway : solution.runways) {
+        moves += runway.sequence.size() * (runway.sequence.size() - 1) / 2;
+    }
+    return moves;
+}
+
+size_t inter_swap_moves(const Solution &solution) {
+    size_t moves = 0;
+    for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+        for (size_t runway_j = runway_i + 1; runway_j < solution.runways.size(); ++runway_j) {
+            moves += solution.runways[runway_i].sequence.size() * solution.runways[runway_j].sequence.size();
+        }
+    }
+    return moves;
+}
+
+size_t intra_move_moves(const Solution &solution) {
+    size_t moves = 0;
+    for (const Runway &runway : solution.runways) {
+        moves += runway.sequence.size() * (runway.sequence.size() - 1);
+    }
+    return moves;
+}
+
+size_t inter_move_moves(const Solution &solution) {
+    size_t moves = 0;
+    for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+        if (solution.runways[runway_i].sequence.size() == 1) continue; // A runway is never emptied
+
+        for (size_t runway_j = 0; runway_j < solution.runways.size(); ++runway_j) {
+            if (runway_i == runway_j) continue;
+            moves += solution.runways[runway_i].sequence.size() * (solution.runways[runway_j].sequence.size() + 1);
+        }
+    }
+    return moves;
+}
+
+// An instance and the solution every benchmark of it starts from
+struct Fixture {
+    std::string name;
+    std::unique_ptr<Instance> instance;
+    std::vector<std::vector<size_t>> sequences; // Lowest release time insertion, every runway has a flight
+};
+
+// Operation on solution (bound to asp.flights_perturbation), timed alone
+using Kernel = std::function<void(ASP &asp, Solution &solution)>;
+
+void run_kernel(benchmark::State &state, const Fixture &fixture, const Kernel &kernel, const MoveCount count_moves) {
+    ASP asp(*fixture.instance, SEED);
+    Solution base;
+    Solution solution;
+    asp.load_solution(base, fixture.sequences, asp.flights);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        asp.copy_solution(solution, base, asp.flights_perturbation);
+        asp.clear_visited_optima();
+        state.ResumeTiming();
+
+        kernel(asp, solution);
+        benchmark::DoNotOptimize(solution.objective);
+    }
+
+    state.counters["flights"] = static_cast<double>(fixture.instance->get_num_flights());
+    if (count_moves != nullptr) {
+        // Seconds per evaluated move (shown with an SI prefix, e.g. 12.3n)
+        state.counters["time_per_move"] = benchmark::Counter(
+            static_cast<double>(count_moves(base)),
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    }
+}
+
+// Construction into asp.flights (the generator goes on from one call to the next)
+using Construction = std::function<Solution(ASP &asp)>;
+
+void run_construction(benchmark::State &state, const Fixture &fixture, const Construction &construction) {
+    ASP asp(*fixture.instance, SEED);
+
+    for (auto _ : state) {
+        Solution solution = construction(asp);
+        benchmark::DoNotOptimize(solution.objective);
+    }
+
+    state.counters["flights"] = static_cast<double>(fixture.instance->get_num_flights());
+    state.counters["time_per_flight"] =
+        benchmark::Counter(static_cast<double>(fixture.instance->get_num_flights()),
+                           benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void register_benchmarks(const Fixture &fixture) {
+    const auto neighborhood = [&](const std::string &name, bool (ASP::*scan)(Solution &), const MoveCount moves) {
+        benchmark::RegisterBenchmark(
+            ("neighborhood/" + name + "/" + fixture.name).c_str(),
+            [&fixture, scan, moves](benchmark::State &state) {
+                run_kernel(
+                    state, fixture, [scan](ASP &asp, Solution &solution) { (asp.*scan)(solution); }, moves);
+            })
+            ->Unit(benchmark::kMicrosecond);
+    };
+    neighborhood("best_improvement_intra_swap", &ASP::best_improvement_intra_swap, intra_swap_moves);
+    neighborhood("best_improvement_inter_swap", &ASP::best_improvement_inter_swap, inter_swap_moves);
+    neighborhood("best_improvement_intra_move", &ASP::best_improvement_intra_move, intra_move_moves);
+    neighborhood("best_improvement_inter_move", &ASP::best_improvement_inter_move, inter_move_moves);
+    neighborhood("best_improvement_time_slot_assignment", &ASP::best_improvement_time_slot_assignment, nullptr);
+    neighborhood("first_improvement_intra_swap", &ASP::first_improvement_intra_swap, nullptr);
+    neighborhood("first_improvement_inter_swap", &ASP::first_improvement_inter_swap, nullptr);
+    neighborhood("first_improvement_intra_move", &ASP::first_improvement_intra_move, nullptr);
+    neighborhood("first_improvement_inter_move", &ASP::first_improvement_inter_move, nullptr);
+
+    benchmark::RegisterBenchmark(("local_search/RVND/" + fixture.name).c_str(),
+                                 [&fixture](benchmark::State &state) {
+                                     run_kernel(
+                                         state, fixture, [](ASP &asp, Solution &solution) { asp.RVND(solution); },
+                                         nullptr);
+                                 })
+        ->Unit(benchmark::kMillisecond);
+
+    const auto construction = [&](const std::string &name, const Construction &construct) {
+        benchmark::RegisterBenchmark(("construction/" + name + "/" + fixture.name).c_str(),
+                                     [&fixture, construct](benchmark::State &state) {
+                                         run_construction(state, fixture, construct);
+                                     })
+            ->Unit(benchmark::kMicrosecond);
+    };
+    construction("randomized_greedy",
+                 [](ASP &asp) { return asp.randomized_greedy(0.01, asp.flights); }); // Alpha of GRASP_VND
+    construction("lowest_release_time_insertion",
+                 [](ASP &asp) { return asp.lowest_release_time_insertion(asp.flights); });
+    construction("rand_lowest_release_time_insertion",
+                 [](ASP &asp) { return asp.rand_lowest_release_time_insertion(asp.flights); });
+    construction("regret_insertion", [](ASP &asp) { return asp.regret_insertion(2, asp.flights); });
+
+    const auto perturbation = [&](const std::string &name, void (ASP::*perturb)(Solution &)) {
+        benchmark::RegisterBenchmark(
+            ("perturbation/" + name + "/" + fixture.name).c_str(),
+            [&fixture, perturb](benchmark::State &state) {
+                run_kernel(
+                    state, fixture, [perturb](ASP &asp, Solution &solution) { (asp.*perturb)(solution); }, nullptr);
+            })
+            ->Unit(benchmark::kMicrosecond);
+    };
+    perturbation("intra_swap", &ASP::intra_swap);
+    perturbation("inter_swap", &ASP::inter_swap);
+    perturbation("intra_move", &ASP::intra_move);
+    perturbation("inter_move", &ASP::inter_move);
+    perturbation("chain", &ASP::chain);
+    perturbation("random_inter_block_swap", &ASP::random_inter_block_swap);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // The remaining argument, if any, is the data directory
+    const std::filesystem::path data_dir = argc > 1 ? argv[1] : ASP_DATA_DIR;
+
+    std::vector<std::filesystem::path> instance_files;
+    for (const char *subdir : {"instances", "copa_instances"}) {
+        if (not std::filesystem::is_directory(data_dir / subdir)) continue;
+
+        for (const auto &entry : std::filesystem::directory_iterator(data_dir / subdir)) {
+            if (entry.path().extension() == ".txt") instance_files.push_back(entry.path());
+        }
+    }
+    if (instance_files.empty()) {
+        std::cerr << "No instance found in " << data_dir << '\n';
+        return 1;
+    }
+    std::sort(instance_files.begin(), instance_files.end());
+
+    // Fixtures live until the end of main, the benchmarks refer to them
+    std::vector<Fixture> fixtures(instance_files.size());
+
+    for (size_t i = 0; i < instance_files.size(); ++i) {
+        Fixture &fixture = fixtures[i];
+        fixture.name = instance_files[i].stem().string();
+        fixture.instance = std::make_unique<Instance>(instance_files[i]);
+
+        ASP asp(*fixture.instance, SEED);
+        asp.lowest_release_time_insertion(asp.flights).get_sequences(fixture.sequences);
+    }
+    for (const Fixture &fixture : fixtures) {
+        register_benchmarks(fixture);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,331 @@
+#include "ASP.hpp"
+#include "instance.hpp"
+#include "solution.hpp"
+
+#include <argparse/argparse.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// End-to-end runs of a metaheuristic over a directory of instances with several seeds. Reports, per instance, the best
+// and average objective, their gap to the best known value (data/best-known-values.csv), the time to best and the time
+// to reach the target (best known value + target gap), as a table and optionally as CSV and JSON.
+
+namespace {
+
+struct Run {
+    uint64_t seed = 0;
+    size_t objective = 0;
+    double elapsed = 0;         // Seconds
+    double time_to_best = 0;    // Seconds
+    double time_to_target = -1; // Seconds, negative if the target was not reached
+};
+
+struct InstanceResult {
+    std::string name;
+    size_t num_flights = 0;
+    size_t num_runways = 0;
+    bool known = false; // Whether the instance has a best known value
+    size_t best_known = 0;
+    size_t target = 0;
+    std::vector<Run> runs;
+
+    size_t best() const {
+        size_t best = std::numeric_limits<size_t>::max();
+        for (const Run &run : runs) {
+            best = std::min(best, run.objective);
+        }
+        return best;
+    }
+
+    template <typename Field> double average(const Field field) const {
+        double sum = 0;
+        for (const Run &run : runs) {
+            sum += static_cast<double>(run.*field);
+        }
+        return runs.empty() ? 0 : sum / static_cast<double>(runs.size());
+    }
+
+    size_t targets_reached() const {
+        return static_cast<size_t>(
+            std::count_if(runs.begin(), runs.end(), [](const Run &run) { return run.time_to_target >= 0; }));
+    }
+
+    // Average time to target of the runs that reached it, negative if none did
+    double average_time_to_target() const {
+        double sum = 0;
+        for (const Run &run : runs) {
+            if (run.time_to_target >= 0) sum += run.time_to_target;
+        }
+        return targets_reached() == 0 ? -1 : sum / static_cast<double>(targets_reached());
+    }
+
+    // Relative gap in percent to the best known value, negative when the objective improves it
+    double gap(const double objective) const {
+        if (not known) return std::numeric_limits<double>::quiet_NaN();
+        if (best_known == 0) return objective == 0 ? 0 : std::numeric_limits<double>::infinity();
+        return 100 * (objective - static_cast<double>(best_known)) / static_cast<double>(best_known);
+    }
+};
+
+// Best known objective of each instance (file name without extension), from a CSV "instance,best_known_value"
+std::map<std::string, size_t> read_best_known_values(const std::filesystem::path &path) {
+    std::map<std::string, size_t> values;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        const size_t comma = line.find(',');
+        if (comma == std::string::npos) continue;
+
+        const std::string value = line.substr(comma + 1);
+        if (value.empty() or value.find_first_not_of("0123456789 \r") != std::string::npos) continue; // Header
+
+        values[line.substr(0, comma)] = std::stoull(value);
+    }
+    return values;
+}
+
+void write_best_known_values(const std::filesystem::path &path, const std::map<std::string, size_t> &values) {
+    std::ofstream file(path);
+    file << "instance,best_known_value\n";
+    for (const auto &[instance, value] : values) {
+        file << instance << ',' << value << '\n';
+    }
+}
+
+// Number for the JSON and CSV files, none (null or empty) when there is no value
+std::string format_number(const double value, const bool present = true, const char *none = "null") {
+    if (not present or not std::isfinite(value)) return none;
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+}
+
+void write_csv(const std::filesystem::path &path, const std::vector<InstanceResult> &results) {
+    std::ofstream file(path);
+    file << "instance,flights,runways,runs,best_known,best,average,gap_best,gap_average,time_to_best,"
+            "targets_reached,time_to_target\n";
+
+    for (const InstanceResult &result : results) {
+        const double average = result.average(&Run::objective);
+
+        file << result.name << ',' << result.num_flights << ',' << result.num_runways << ',' << result.runs.size()
+             << ',' << format_number(static_cast<double>(result.best_known), result.known, "") << ',' << result.best()
+             << ',' << average << ',' << format_number(result.gap(static_cast<double>(result.best())), true, "") << ','
+             << format_number(result.gap(average), true, "") << ',' << result.average(&Run::time_to_best) << ','
+             << result.targets_reached() << ','
+             << format_number(result.average_time_to_target(), result.targets_reached() > 0, "") << '\n';
+    }
+}
+
+void write_json(const std::filesystem::path &path, const std::string &algorithm,
+                const std::vector<InstanceResult> &results) {
+    std::ofstream file(path);
+    file << "{\n  \"algorithm\": \"" << algorithm << "\",\n  \"instances\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const InstanceResult &result = results[i];
+        const double average = result.average(&Run::objective);
+        const bool known = result.known;
+
+        file << (i > 0 ? "," : "") << "\n    {\"instance\": \"" << result.name << "\", \"flights\": "
+             << result.num_flights << ", \"runways\": " << result.num_runways
+             << ", \"best_known\": " << format_number(static_cast<double>(result.best_known), known)
+             << ", \"target\": " << format_number(static_cast<double>(result.target), known)
+             << ", \"best\": " << result.best() << ", \"average\": " << average
+             << ", \"gap_best\": " << format_number(result.gap(static_cast<double>(result.best())))
+             << ", \"gap_average\": " << format_number(result.gap(average))
+             << ", \"time_to_best\": " << result.average(&Run::time_to_best)
+             << ", \"targets_reached\": " << result.targets_reached()
+             << ", \"time_to_target\": "
+             << format_number(result.average_time_to_target(), result.targets_reached() > 0) << ", \"runs\": [";
+
+        for (size_t run_i = 0; run_i < result.runs.size(); ++run_i) {
+            const Run &run = result.runs[run_i];
+
+            file << (run_i > 0 ? ", " : "") << "{\"seed\": " << run.seed << ", \"objective\": " << run.objective
+                 << ", \"elapsed\": " << run.elapsed << ", \"time_to_best\": " << run.time_to_best
+                 << ", \"time_to_target\": " << format_number(run.time_to_target, run.time_to_target >= 0) << "}";
+        }
+        file << "]}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    argparse::ArgumentParser program("asp_runner");
+
+    program.add_argument("instance_dir").help("Directory of the instances (every .txt file)").required();
+
+    program.add_argument("--algorithm")
+        .help("Metaheuristic run on each instance")
+        .default_value(std::string("gils-rvnd"))
+        .choices("gils-rvnd", "parallel-gils-rvnd", "island-gils-rvnd", "racing-gils-rvnd", "rolling-horizon",
+                 "alns");
+
+    program.add_argument("--seeds").help("Runs per instance").default_value(size_t{5}).scan<'i', size_t>();
+    program.add_argument("--first-seed")
+        .help("Seed of the first run, the next ones follow")
+        .default_value(size_t{0})
+        .scan<'i', size_t>();
+
+    program.add_argument("--grasp").help("Number of GRASP iterations").default_value(size_t{1}).scan<'i', size_t>();
+    program.add_argument("--ils").help("Number of ILS iterations").default_value(size_t{10}).scan<'i', size_t>();
+    program.add_argument("--time-limit")
+        .help("Wall-clock budget in seconds of each run (0: no limit)")
+        .default_value(0.0)
+        .scan<'g', double>();
+
+    program.add_argument("--migration-interval")
+        .help("ILS iterations between two migrations of the island model")
+        .default_value(size_t{50})
+        .scan<'i', size_t>();
+    program.add_argument("--lns-iterations")
+        .help("Destroy and repair iterations of ALNS")
+        .default_value(size_t{1000})
+        .scan<'i', size_t>();
+
+    program.add_argument("--best-known")
+        .help("CSV of the best known values (instance,best_known_value)")
+        .default_value(std::string("data/best-known-values.csv"));
+
+    program.add_argument("--target-gap")
+        .help("Target of the time to target, as a gap to the best known value (0.01: within 1%)")
+        .default_value(0.01)
+        .scan<'g', double>();
+
+    program.add_argument("--update-best-known")
+        .help("Write the best objectives found that improve (or are missing from) the best known values")
+        .flag();
+
+    program.add_argument("--csv").help("Write the results per instance to this CSV file");
+    program.add_argument("--json").help("Write the results per instance and per run to this JSON file");
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << '\n';
+        std::cerr << program;
+        return 1;
+    }
+
+    const std::filesystem::path instance_dir = program.get<std::string>("instance_dir");
+    const auto algorithm = program.get<std::string>("--algorithm");
+    const auto num_seeds = program.get<size_t>("--seeds");
+    const auto first_seed = program.get<size_t>("--first-seed");
+    const auto grasp_iterations = program.get<size_t>("--grasp");
+    const auto ils_iterations = program.get<size_t>("--ils");
+    const auto target_gap = program.get<double>("--target-gap");
+    const std::filesystem::path best_known_file = program.get<std::string>("--best-known");
+
+    std::vector<std::filesystem::path> instance_files;
+    if (std::filesystem::is_directory(instance_dir)) {
+        for (const auto &entry : std::filesystem::directory_iterator(instance_dir)) {
+            if (entry.path().extension() == ".txt") instance_files.push_back(entry.path());
+        }
+    }
+    if (instance_files.empty()) {
+        std::cerr << "No instance found in " << instance_dir << '\n';
+        return 1;
+    }
+    std::sort(instance_files.begin(), instance_files.end());
+
+    std::map<std::string, size_t> best_known_values = read_best_known_values(best_known_file);
+    std::vector<InstanceResult> results;
+
+    std::cout << std::left << std::setw(12) << "Instance" << std::right << std::setw(10) << "BKV" << std::setw(10)
+              << "Best" << std::setw(12) << "Average" << std::setw(10) << "Gap (%)" << std::setw(12) << "TTB (s)"
+              << std::setw(9) << "Target" << std::setw(12) << "TTT (s)" << '\n';
+
+    for (std::filesystem::path instance_file : instance_files) {
+        Instance instance(instance_file);
+
+        InstanceResult &result = results.emplace_back();
+        result.name = instance_file.stem().string();
+        result.num_flights = instance.get_num_flights();
+        result.num_runways = instance.get_num_runways();
+
+        if (const auto known = best_known_values.find(result.name); known != best_known_values.end()) {
+            result.known = true;
+            result.best_known = known->second;
+            result.target = static_cast<size_t>(static_cast<double>(known->second) * (1 + target_gap));
+        }
+
+        for (size_t seed = first_seed; seed < first_seed + num_seeds; ++seed) {
+            ASP asp(instance, seed);
+            asp.time_limit = program.get<double>("--time-limit");
+            asp.target_objective = result.target; // Not reported without a best known value
+
+            // The metaheuristics report their progress on std::cout, only the table is shown
+            std::ostringstream silenced;
+            std::streambuf *const cout_buffer = std::cout.rdbuf(silenced.rdbuf());
+            const auto start = std::chrono::steady_clock::now();
+
+            Solution solution;
+            if (algorithm == "parallel-gils-rvnd") {
+                solution = asp.parallel_GILS_RVND(grasp_iterations, ils_iterations, 0);
+            } else if (algorithm == "island-gils-rvnd") {
+                solution = asp.island_GILS_RVND(grasp_iterations, ils_iterations,
+                                                std::max<size_t>(1, program.get<size_t>("--migration-interval")));
+            } else if (algorithm == "racing-gils-rvnd") {
+                solution = asp.racing_GILS_RVND(grasp_iterations, ils_iterations, 2);
+            } else if (algorithm == "rolling-horizon") {
+                solution = asp.rolling_horizon(ils_iterations, 100, 25);
+            } else if (algorithm == "alns") {
+                solution = asp.ALNS(program.get<size_t>("--lns-iterations"), 0.1);
+            } else {
+                solution = asp.GILS_RVND(grasp_iterations, ils_iterations, 0);
+            }
+
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout.rdbuf(cout_buffer);
+
+            result.runs.push_back({seed, solution.objective, elapsed, asp.time_to_best(),
+                                   result.known ? asp.time_to_target() : -1});
+        }
+
+        const double average = result.average(&Run::objective);
+        const auto cell = [](const double value, const bool present, const int precision) {
+            std::ostringstream stream;
+            stream << std::fixed << std::setprecision(precision) << value;
+            return present and std::isfinite(value) ? stream.str() : std::string("-");
+        };
+
+        std::cout << std::left << std::setw(12) << result.name << std::right << std::setw(10)
+                  << cell(static_cast<double>(result.best_known), result.known, 0) << std::setw(10) << result.best()
+                  << std::setw(12) << cell(average, true, 1) << std::setw(10) << cell(result.gap(average), true, 2)
+                  << std::setw(12) << cell(result.average(&Run::time_to_best), true, 3) << std::setw(9)
+                  << (result.known ? std::to_string(result.targets_reached()) + "/" + std::to_string(result.runs.size())
+                                   : "-")
+                  << std::setw(12) << cell(result.average_time_to_target(), result.targets_reached() > 0, 3) << '\n';
+
+        if (not result.known or result.best() < result.best_known) {
+            best_known_values[result.name] = result.best();
+        }
+    }
+
+    if (auto csv = program.present("--csv")) write_csv(*csv, results);
+    if (auto json = program.present("--json")) write_json(*json, algorithm, results);
+
+    if (program.get<bool>("--update-best-known")) {
+        write_best_known_values(best_known_file, best_known_values);
+        std::cout << "\nBest known values written to " << best_known_file.string() << '\n';
+    }
+    return 0;
+}
@@ -1,37 +1,401 @@
 #ifndef ASP_HPP
 #define ASP_HPP
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <limits>
 #include <random>
 #include <vector>
 
 #include "flight.hpp"
+#include "hungarian.hpp"
 #include "instance.hpp"
+#include "random.hpp"
 #include "solution.hpp"
 
 class ASP {
+public:
+    enum class Neighborhood : uint8_t { IntraSwap, InterSwap, IntraMove, InterMove, TimeSlotAssignment };
+    enum class NeighborhoodSelection : uint8_t { Uniform, UCB };
+    enum class Acceptance : uint8_t { Strict, Threshold, LateAcceptance, SimulatedAnnealing };
+
+    static constexpr size_t NUM_NEIGHBORHOODS = 5;
+
+    struct NeighborhoodStatistics {
+        uint64_t calls = 0;
+        uint64_t improvements = 0;
+        uint64_t total_gain = 0;
+        double total_time_us = 0;
+        double total_reward = 0; // Sum of gain per microsecond of every call
+    };
+
+    // Neighborhoods, perturbations and constructions whose calls are counted (see operator_statistics)
+    enum class Operator : uint8_t {
+        BestImprovementIntraSwap,
+        BestImprovementInterSwap,
+        BestImprovementIntraMove,
+        BestImprovementInterMove,
+        BestImprovementTimeSlotAssignment,
+        FirstImprovementIntraSwap,
+        FirstImprovementInterSwap,
+        FirstImprovementIntraMove,
+        FirstImprovementInterMove,
+        MoveWorstFlight,
+        IntraSwap,
+        InterSwap,
+        InterMove,
+        Chain,
+        RandomInterBlockSwap,
+        RandomizedGreedy,
+        LowestReleaseTimeInsertion,
+        RandLowestReleaseTimeInsertion,
+        RegretInsertion
+    };
+
+    static constexpr size_t NUM_OPERATORS = 19;
+
+    struct OperatorStatistics {
+        uint64_t calls = 0;
+        uint64_t evaluated = 0; // Moves considered by the scans
+        uint64_t pruned = 0;    // Moves dropped before their penalty was complete, as they can not improve
+        uint64_t shortcuts = 0; // Penalties completed from the prefix penalties, the rest of the runway being unchanged
+        uint64_t improvements = 0;
+        int64_t total_gain = 0; // Objective decrease (negative for the perturbations)
+        double total_time_us = 0;
+    };
+
 private:
-    Instance m_instance;
+    // Best move of a runway or runway pair found by a neighborhood scan
+    struct Move {
+        uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
+        size_t runway_i = 0;
+        size_t runway_j = 0;
+        size_t flight_i = 0;
+        size_t flight_j = 0;
+
+        // Counters of the scan, see OperatorStatistics
+        struct Counters {
+            uint32_t evaluated = 0;
+            uint32_t pruned = 0;
+            uint32_t shortcuts = 0;
+        } counters;
+    };
+
+    const Instance &m_instance; // Read-only, shared by the workers of the parallel metaheuristics
 
-    std::mt19937 m_generator;
+    Xoshiro256 m_generator; // Every random decision of the ASP goes through it, so a seed fixes the whole run
+
+    // Uniform index in [0, n)
+    size_t random_index(size_t n) { return m_generator.bounded(n); }
 
     Flight m_dummy_flight;
 
+    std::vector<Move> m_moves; // One entry per runway (pair) scanned, so threads never share an entry
+    std::vector<Move> m_selected_moves;
+    std::vector<bool> m_runway_touched;
+
+    // Improving moves of m_moves to apply: greedily by decreasing delta, skipping moves on an already touched runway
+    // (only the best one if multi_move is off). Ties keep the scan order, as in a sequential scan.
+    const std::vector<Move> &select_moves();
+
+    std::array<OperatorStatistics, NUM_OPERATORS> m_operator_statistics{};
+
+    // Counts a call of an operator and its wall time, and the objective decrease of solution (if any) over the call.
+    // Each worker counts in its own ASP, merged at the end like the other statistics.
+    class OperatorScope {
+    public:
+        OperatorScope(ASP &asp, Operator op, const Solution *solution = nullptr);
+        OperatorScope(const OperatorScope &) = delete;
+        OperatorScope &operator=(const OperatorScope &) = delete;
+        ~OperatorScope();
+
+        // Add the counters of the last scan (m_moves) to the operator
+        void count_moves(const std::vector<Move> &moves);
+
+        OperatorStatistics &statistics;
+
+    private:
+        const Solution *m_solution;
+        size_t m_original_objective;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    void add_operator_statistics(const std::array<OperatorStatistics, NUM_OPERATORS> &operator_statistics);
+
+    uint64_t m_improving_passes = 0; // Best improvement scans that applied at least one move
+    uint64_t m_applied_moves = 0;
+
+    // Time-slot assignment neighborhood
+    uint32_t m_slot_window = 0; // Half-width of the time window whose flights are reassigned
+    Hungarian m_hungarian;
+    std::vector<uint32_t> m_slot_costs;
+    std::vector<size_t> m_slot_positions;
+    std::vector<size_t> m_slot_runways;
+    std::vector<size_t> m_slot_assignment;
+    std::vector<size_t> m_earlier_slot_runways; // Slots selected by an anchor scanned before
+    std::vector<size_t> m_earlier_slot_positions;
+    std::vector<size_t> m_best_slot_runways;
+    std::vector<size_t> m_best_slot_positions;
+    std::vector<size_t> m_best_slot_assignment;
+    std::vector<std::reference_wrapper<Flight>> m_slot_flights;
+
+    // Slot of each runway around anchor_time: its flight whose start time is nearest, if within m_slot_window
+    void select_time_slots(const Solution &solution, uint32_t anchor_time, std::vector<size_t> &runways,
+                           std::vector<size_t> &positions) const;
+
+    // Destroy and repair operators
+    std::vector<std::reference_wrapper<Flight>> m_destroy_candidates;
+    std::vector<std::reference_wrapper<Flight>> m_removed_flights;
+    std::vector<bool> m_is_removed;
+    std::vector<size_t> m_remaining_flights; // Flights left in each runway during a destroy
+    std::vector<uint32_t> m_insertion_costs; // Best insertion cost of each (removed flight, runway)
+    std::vector<size_t> m_insertion_positions;
+    std::vector<uint32_t> m_regret_costs;
+
+    void update_insertion_cost(const Solution &solution, size_t removed_i, size_t runway_i);
+
+    // Insert m_removed_flights one at a time at its cheapest position, the flight with the largest regret (sum of the
+    // differences between its best runway and its next regret_k - 1 best runways) first. regret_k = 1 is greedy.
+    void insert_removed_flights(Solution &solution, size_t regret_k);
+
+    // Elite pool of GILS-RVND local optima and path relinking between them
+    struct EliteSolution {
+        size_t objective = 0;
+        std::vector<std::vector<size_t>> sequences;
+        std::vector<size_t> predecessors; // Previous flight on the same runway (num_flights for the first one)
+    };
+    std::vector<EliteSolution> m_elite_pool;
+    EliteSolution m_elite_candidate;
+    std::vector<size_t> m_guide_runways;
+    std::vector<size_t> m_guide_positions;
+    std::vector<uint32_t> m_relink_costs;
+    std::vector<size_t> m_relink_assignment;
+    std::vector<size_t> m_relink_targets; // Runway of the solution matched with each runway of the guide
+    std::vector<size_t> m_relink_pending;
+    std::vector<std::vector<size_t>> m_relink_orders; // Guide order of the flights of each runway
+    std::vector<size_t> m_relink_fixed;               // Positions of each runway already in the guide order
+    std::vector<std::vector<size_t>> m_relink_origin;
+    std::vector<std::vector<std::vector<size_t>>> m_relink_candidates;
+
+    void compute_predecessors(EliteSolution &elite) const;
+    size_t elite_distance(const EliteSolution &a, const EliteSolution &b) const;
+
+    // Insert solution in the pool if it is a new best, or better than the worst and different enough from the pool
+    bool add_to_elite_pool(const Solution &solution);
+
+    // Walk from solution (bound to flights) toward guide, moving flights to the guide's runways and then into the
+    // guide's order, and apply RVND to the best intermediate solutions.
+    // solution becomes the best of them if it improves, and is left unchanged otherwise.
+    bool path_relinking(Solution &solution, const EliteSolution &guide);
+
+    // Wall-clock budget of the running metaheuristic
+    std::chrono::steady_clock::time_point m_start_time;
+    std::chrono::steady_clock::time_point m_deadline;
+    size_t m_best_objective = 0;
+    double m_time_to_best = 0;
+    double m_time_to_target = -1;
+
+    void start_clock();
+    bool time_expired() const { return time_limit > 0 && std::chrono::steady_clock::now() >= m_deadline; }
+    void update_time_to_best(size_t objective); // Call whenever a solution may be a new best of the run
+
+    // Adaptive neighborhood selection in RVND (kept across ILS iterations)
+    std::array<NeighborhoodStatistics, NUM_NEIGHBORHOODS> m_neighborhood_statistics{};
+    uint64_t m_neighborhood_calls = 0;
+
+    Neighborhood select_neighborhood(uint32_t active_neighborhoods);
+
+    // Perturbation of the ILS, its strength grows with the number of iterations without improvement.
+    // extra_strength adds block swaps, used when the previous iterations fell back into known local optima.
+    void perturb(Solution &solution, size_t ils_iteration, size_t extra_strength = 0);
+
+    // Hashes of the local optima reached by RVND, direct-mapped so that the set stays bounded (a power of two of
+    // slots, a new optimum evicts the one in its slot)
+    static constexpr size_t VISITED_OPTIMA_CAPACITY = size_t{1} << 16;
+    std::vector<uint64_t> m_visited_optima;
+    uint64_t m_local_searches = 0;
+    uint64_t m_revisits = 0;
+    bool m_revisited = false; // The last RVND reached a known local optimum and stopped early
+
+    // Flights of the best solution returned by GILS-RVND and ALNS, which their next iterations do not reschedule
+    std::vector<Flight> m_best_flights;
+
+    // Acceptance criterion of the ILS, the incumbent is kept apart from local_best unless acceptance is strict
+    std::vector<Flight> m_incumbent_flights;
+    std::vector<size_t> m_late_acceptance; // Incumbent objectives of the last late_acceptance_length iterations
+    uint64_t m_acceptance_iteration = 0;
+    uint64_t m_accepted_worse = 0;
+
+    // Whether the search moves from an incumbent of objective current to a candidate of objective candidate under
+    // criterion. best is the objective of local_best and progress in [0, 1] drives the threshold and temperature
+    // schedules.
+    bool accept(Acceptance criterion, size_t candidate, size_t current, size_t best, double progress);
+
+    // Perturbation + RVND iterations around local_best (bound to flights), until max_ils_iterations without improvement
+    // or after budget iterations. Returns the ILS iteration to resume from (above max_ils_iterations once converged).
+    size_t ILS_RVND(Solution &local_best, size_t max_ils_iterations, // NOLINT
+                    size_t budget = std::numeric_limits<size_t>::max(), size_t ils_iteration = 1);
+
+    // Reinsert each of flight_ids at its best position, on any runway, among the positions around its release time.
+    // Repeats until no reinsertion improves, returns whether solution (bound to flights) improved.
+    bool boundary_local_search(Solution &solution, const std::vector<size_t> &flight_ids);
+
+    // construction_batch starting solutions built in parallel by workers (one per thread), each with its own generator
+    // so that the batch does not depend on the number of threads. local_best (bound to flights) becomes the best one
+    // after the screening.
+    void batch_construct(Solution &local_best, std::vector<ASP> &workers);
+
+    // Checkpoint of GILS-RVND: the progress of the running iteration, besides the state kept in members
+    struct Checkpoint {
+        uint64_t iteration = 1;
+        uint64_t ils_iteration = 1;
+        uint64_t revisits = 0;
+        double elapsed = 0; // Seconds since the start of the run
+        std::vector<std::vector<size_t>> best_found;
+        std::vector<std::vector<size_t>> local_best;
+        std::vector<std::vector<size_t>> incumbent; // Empty with strict acceptance
+        std::vector<size_t> late_acceptance;
+        uint64_t acceptance_iteration = 0;
+    };
+    Checkpoint m_checkpoint;
+    bool m_checkpointing = false;   // GILS-RVND is running with a checkpoint_file
+    bool m_resume_pending = false;  // The next ILS continues from m_checkpoint
+    const Solution *m_checkpoint_best = nullptr;
+    std::chrono::steady_clock::time_point m_next_checkpoint;
+
+    // Write a checkpoint if checkpoint_interval elapsed since the last one (called after each ILS iteration)
+    void checkpoint(const Solution &local_best, const Solution *incumbent, size_t ils_iteration, size_t revisits);
+
+    // Atomic write of m_checkpoint and the search state: the file is written aside, then renamed over the old one
+    void write_checkpoint();
+
+    // Restore m_checkpoint and the search state, returns false if there is no checkpoint file
+    bool read_checkpoint();
+
+    // Add the statistics gathered by a worker copy of this ASP
+    void merge_statistics(const ASP &worker);
+
+    // Convergence trace of GILS-RVND, parallel GILS-RVND and ALNS: a ring buffer of the last trace_capacity points
+    struct TracePoint {
+        uint64_t elapsed_ns = 0;  // Since the start of the run
+        size_t iteration = 0;     // GRASP iteration (ALNS iteration for ALNS)
+        size_t ils_iteration = 0; // ILS iterations without improvement, 0 at the start of a GRASP iteration, in ALNS
+                                  // and in parallel GILS-RVND, which only records its new bests
+        size_t incumbent = 0;     // Objective of the solution the ILS perturbs (the current solution of ALNS)
+        size_t best = 0;          // Best objective of the run
+    };
+    std::vector<TracePoint> m_trace;
+    size_t m_trace_points = 0; // Recorded since the start of the run, the oldest ones are overwritten
+    size_t m_iteration = 0;
+    bool m_tracing = false; // A traced metaheuristic is running (never one of the workers of the parallel ones)
+    std::chrono::steady_clock::time_point m_next_progress;
+
+    // Empty the trace and record from now on, after start_clock
+    void start_trace();
+
+    // Record a point when the incumbent or the best changes, and print the progress if progress_interval elapsed
+    void trace(size_t ils_iteration, size_t incumbent);
+
 public:
-    enum class Neighborhood : uint8_t { IntraSwap, InterSwap, IntraMove, InterMove };
     enum class Perturbation : uint8_t { IntraSwap, InterSwap, IntraMove, InterMove };
+    enum class Destroy : uint8_t { Random, TimeWindow, Runway, WorstDelay };
+    enum class Repair : uint8_t { Greedy, Regret2, Regret3 };
+    enum class Construction : uint8_t { RandLowestReleaseTime, LowestReleaseTime, Regret };
     std::vector<Flight> flights;
     std::vector<Flight> flights_perturbation;
 
+    NeighborhoodSelection neighborhood_selection = NeighborhoodSelection::Uniform;
+    bool parallel_neighborhoods = false; // Scan runways (pairs) of the best improvement neighborhoods in parallel
+    size_t elite_size = 10; // Elite solutions kept by GILS-RVND for path relinking (0 disables it)
+    double time_limit = 0; // Seconds a metaheuristic may run (0 = no limit), it then returns the best found so far
+    std::vector<std::vector<size_t>> initial_solution; // Runways the first GILS-RVND iteration starts from (if any)
+    std::filesystem::path checkpoint_file; // GILS-RVND saves its state there periodically (if set)
+    double checkpoint_interval = 5;         // Seconds between two checkpoints
+    bool resume = false;                    // GILS-RVND continues from checkpoint_file if it exists
+    size_t trace_capacity = 0;              // Points of the GILS-RVND convergence trace kept (0: no trace)
+    double progress_interval = 0;           // Seconds between two GILS-RVND progress lines (0: none)
+    bool multi_move = true; // Apply every improving move on disjoint runways found by a best improvement scan
+
+    Construction construction = Construction::RandLowestReleaseTime; // Initial solutions of the metaheuristics
+    size_t regret_k = 2; // Runways compared by the regret construction
+    size_t target_objective = 0; // Objective whose time to reach is recorded (see time_to_target)
+    size_t construction_batch = 1; // Starting solutions built in parallel per GILS-RVND iteration, the best one is kept
+    size_t screening_calls = 0;    // Neighborhood scans of the truncated RVND that screens them (0: by objective)
+
+    Acceptance acceptance = Acceptance::Strict; // Which perturbed local optima become the ILS incumbent
+    double acceptance_ratio = 0.005;   // Initial threshold or temperature, as a fraction of the local best objective
+    size_t late_acceptance_length = 50; // History length of late acceptance hill climbing
+
+    // Copy source into target, rebinding the runways' sequences to target_flights
+    void copy_solution(Solution &target, const Solution &source, std::vector<Flight> &target_flights);
+
+    // Build target from the flight ids of each runway (see Solution::get_sequences), bound to target_flights
+    void load_solution(Solution &target, const std::vector<std::vector<size_t>> &sequences,
+                       std::vector<Flight> &target_flights);
+
+    // Solution bound to target_flights from the runways of a previous schedule (see Solution::read_sequences), in
+    // O(n) when it holds every flight. Unknown and repeated flights are dropped, missing ones go to their cheapest
+    // position.
+    Solution warm_start(const std::vector<std::vector<size_t>> &sequences, std::vector<Flight> &target_flights);
+
     // Constructive heuristics
 
     Solution randomized_greedy(double alpha, std::vector<Flight> &flights);
     Solution lowest_release_time_insertion(std::vector<Flight> &flights);
     Solution rand_lowest_release_time_insertion(std::vector<Flight> &flights);
 
+    // Every flight inserted at its cheapest position, the one with the largest regret-k first (deterministic)
+    Solution regret_insertion(size_t regret_k, std::vector<Flight> &flights);
+
+    // Initial solution of the metaheuristics, by the selected construction
+    Solution construct(std::vector<Flight> &flights);
+
     // Local search procedures
 
-    void VND(Solution &solution);  // NOLINT
-    void RVND(Solution &solution); // NOLINT
+    void VND(Solution &solution); // NOLINT
+
+    // Stops after max_calls neighborhood scans if it has not converged by then
+    void RVND(Solution &solution, size_t max_calls = std::numeric_limits<size_t>::max()); // NOLINT
+
+    // Forget the local optima reached so far, so that RVND runs again in full from a known solution (benchmarks)
+    void clear_visited_optima() { std::fill(m_visited_optima.begin(), m_visited_optima.end(), 0); }
+
+    // Flights read again from the instance after it was changed in place, e.g. the window of the online mode reused
+    // from one change to the next. The buffers keep their capacity.
+    void reload_instance();
+
+    // Share of the average reward (gain per microsecond) of each neighborhood
+    std::array<double, NUM_NEIGHBORHOODS> neighborhood_weights() const;
+    const std::array<NeighborhoodStatistics, NUM_NEIGHBORHOODS> &neighborhood_statistics() const {
+        return m_neighborhood_statistics;
+    }
+    void print_neighborhood_weights() const;
+
+    // Counters of every operator, summed over the workers of the parallel metaheuristics
+    const std::array<OperatorStatistics, NUM_OPERATORS> &operator_statistics() const { return m_operator_statistics; }
+    static const char *operator_name(Operator op);
+    static const char *operator_kind(Operator op); // "neighborhood", "perturbation" or "construction"
+
+    // Convergence trace of the last GILS-RVND run as CSV (elapsed_ns, iteration, ils_iteration, incumbent, best),
+    // oldest point first
+    void write_trace(const std::filesystem::path &path) const;
+
+    // Seconds from the start of the last metaheuristic run to its best solution
+    double time_to_best() const { return m_time_to_best; }
+
+    // Seconds of the last run until a solution reached target_objective, negative if none did
+    double time_to_target() const { return m_time_to_target; }
+
+    // Share of the RVND runs that fell into an already visited local optimum
+    double revisit_rate() const;
+
+    // Average number of moves applied by an improving best improvement scan
+    double moves_per_pass() const;
+
+    // ILS iterations whose perturbed local optimum was accepted although it is worse than the incumbent
+    uint64_t accepted_worse() const { return m_accepted_worse; }
 
     // Neighborhoods
 
@@ -39,6 +403,7 @@ public:
     bool best_improvement_inter_swap(Solution &solution);
     bool best_improvement_intra_move(Solution &solution);
     bool best_improvement_inter_move(Solution &solution);
+    bool best_improvement_time_slot_assignment(Solution &solution);
     bool move_worst_flight(Solution &Solution);
     bool first_improvement_inter_swap(Solution &solution);
     bool first_improvement_intra_move(Solution &solution);
@@ -52,6 +417,16 @@ public:
     Solution GILS_VND(size_t max_iterations, size_t max_ils_iterations, double alpha);         // NOLINT
     Solution GILS_VND_2(size_t max_iterations, size_t max_ils_iterations, double alpha);       // NOLINT
     Solution GILS_RVND(size_t max_iterations, size_t max_ils_iterations, double alpha);        // NOLINT
+    Solution parallel_GILS_RVND(size_t max_iterations, size_t max_ils_iterations, double alpha); // NOLINT
+    Solution island_GILS_RVND(size_t max_iterations, size_t max_ils_iterations,              // NOLINT
+                              size_t migration_interval);
+    Solution racing_GILS_RVND(size_t max_iterations, size_t max_ils_iterations,              // NOLINT
+                              size_t reduction_factor);
+    // RVND then ILS-RVND on solution (bound to flights), within time_limit
+    void improve(Solution &solution, size_t max_ils_iterations);
+
+    Solution rolling_horizon(size_t max_ils_iterations, size_t window_size, size_t window_overlap); // NOLINT
+    Solution ALNS(size_t max_iterations, double destroy_ratio);                                // NOLINT
 
     // Perturbations
     void P4(Solution &solution); // NOLINT
@@ -63,9 +438,12 @@ public:
     void intra_move(Solution &solution);
     void inter_move(Solution &solution);
     void chain(Solution &Solution);
-    
 
-    ASP(Instance &instance);
+    // Destroy and repair operators
+    void destroy(Solution &solution, Destroy destroy_operator, size_t num_flights);
+    void repair(Solution &solution, Repair repair_operator);
+
+    ASP(const Instance &instance, uint64_t seed = 0);
 };
 
 #endif
@@ -23,6 +23,7 @@ public:
     inline uint32_t get_release_time() const { return m_release_time; }
     inline uint32_t get_runway_occupancy_time() const { return m_runway_occupancy_time; }
     inline uint32_t get_delay_penalty() const { return m_delay_penalty; }
+    inline uint32_t get_delay_cost() const { return (start_time - m_release_time) * m_delay_penalty; }
 };
 
 #endif
@@ -0,0 +1,25 @@
+#ifndef HUNGARIAN_HPP
+#define HUNGARIAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Exact solver for the square linear assignment problem (Hungarian method, O(n^3)).
+// The internal buffers are kept between calls, so repeated solves of the same size do not allocate.
+class Hungarian {
+private:
+    std::vector<int64_t> m_u;
+    std::vector<int64_t> m_v;
+    std::vector<int64_t> m_min_v;
+    std::vector<size_t> m_p;
+    std::vector<size_t> m_way;
+    std::vector<bool> m_used;
+
+public:
+    // cost is a row-major n x n matrix; assignment[row] receives the column assigned to row.
+    // Returns the cost of the optimal assignment.
+    uint64_t solve(const std::vector<uint32_t> &cost, size_t n, std::vector<size_t> &assignment);
+};
+
+#endif
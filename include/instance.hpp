@@ -7,6 +7,9 @@
 #include <vector>
 
 class Instance {
+public:
+    static constexpr uint32_t MAX_ANCHOR_PENALTY = 1U << 15; // Keeps delayed anchors from overflowing penalties
+
 private:
     size_t m_num_flights;
     size_t m_num_runways;
@@ -18,6 +21,10 @@ private:
 public:
     Instance(std::filesystem::path &instance_file_path);
 
+    // Instance given by its data, e.g. a part of another instance (separation_time_matrix is row-major)
+    Instance(size_t num_runways, std::vector<uint32_t> release_times, std::vector<uint32_t> runway_occupancy_times,
+             std::vector<uint32_t> delay_penalties, std::vector<uint32_t> separation_time_matrix);
+
     inline size_t get_num_flights() const { return m_num_flights; }
     inline size_t get_num_runways() const { return m_num_runways; }
     inline uint32_t get_release_time(size_t flight) const { return m_release_times[flight]; }
@@ -27,6 +34,13 @@ public:
         return m_separation_time_matrix[(flight_a * m_num_flights) + flight_b];
     }
 
+    inline void set_release_time(size_t flight, uint32_t release_time) { m_release_times[flight] = release_time; }
+
+    // Instance of flights (in this order) whose last anchor_start_times.size() ones are anchors: released at
+    // anchor_start_times, delayed by any flight scheduled before them and weighted by anchor_penalty
+    Instance window(const std::vector<size_t> &flights, const std::vector<uint32_t> &anchor_start_times,
+                    uint32_t anchor_penalty) const;
+
     void print() const;
 };
 
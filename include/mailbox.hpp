@@ -0,0 +1,43 @@
+#ifndef MAILBOX_HPP
+#define MAILBOX_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Lock-free bounded queue between exactly one producer thread and one consumer thread.
+// Values are copied into preallocated slots and swapped out, so buffers keep their capacity once warmed up.
+template <typename T, size_t CAPACITY> class Mailbox {
+private:
+    std::array<T, CAPACITY + 1> m_slots{}; // One slot is always free to tell a full queue from an empty one
+
+    alignas(64) std::atomic<size_t> m_head{0}; // Next slot to read, written only by the consumer
+    alignas(64) std::atomic<size_t> m_tail{0}; // Next slot to write, written only by the producer
+
+public:
+    // Producer side. Returns false, dropping value, if the queue is full.
+    bool push(const T &value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t next_tail = (tail + 1) % (CAPACITY + 1);
+
+        if (next_tail == m_head.load(std::memory_order_acquire)) return false;
+
+        m_slots[tail] = value;
+        m_tail.store(next_tail, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool pop(T &value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        std::swap(value, m_slots[head]);
+        m_head.store((head + 1) % (CAPACITY + 1), std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ONLINE_HPP
+#define ONLINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ASP.hpp"
+#include "instance.hpp"
+#include "random.hpp"
+#include "solution.hpp"
+
+// Change of a flight received by the online mode
+struct FlightEvent {
+    enum class Type : uint8_t { Insert, Update, Remove };
+
+    Type type = Type::Insert;
+    size_t flight = 0;
+    uint32_t release_time = 0; // New release time of an update
+};
+
+// Stand-in for a live feed: every flight of instance arrives by release time, and some of the flights already
+// received slip (their release time grows) or are cancelled
+std::vector<FlightEvent> stand_in_event_stream(const Instance &instance, uint64_t seed);
+
+// Schedule kept up to date while flights are inserted, updated and removed. Every change is repaired locally: the
+// flight goes to its cheapest position, then RVND and a few ILS iterations run on a window of the flights around the
+// change (see Instance::window), kept only if the whole schedule improves.
+//
+// The schedule is kept as flight ids rather than a Solution, since a Solution holds every flight of its instance.
+class OnlineASP {
+private:
+    Instance m_instance; // Every flight that may be scheduled, with its current release time
+    Xoshiro256 m_generator;
+
+    std::vector<std::vector<size_t>> m_runways; // Flight ids of each runway in order
+    std::vector<uint32_t> m_start_times;
+    std::vector<size_t> m_runway_of;
+    std::vector<bool> m_scheduled;
+    size_t m_objective = 0;
+
+    // Region repair
+    std::vector<size_t> m_block_begin; // Positions [begin, end) of each runway in the window
+    std::vector<size_t> m_block_end;
+    std::vector<size_t> m_window_flights;
+    std::vector<uint32_t> m_anchor_start_times;
+    std::vector<size_t> m_anchor_runways;
+    std::vector<std::vector<size_t>> m_window_sequences;
+    std::vector<std::vector<size_t>> m_saved_runways;
+    std::vector<uint32_t> m_saved_start_times;
+    std::vector<size_t> m_saved_runway_of;
+
+    // Instance of the last window, replaced in place so that m_window_asp (bound to it) keeps its flights and
+    // buffers from one repair to the next
+    Instance m_window_instance;
+    ASP m_window_asp;
+    Solution m_window_solution;
+
+    uint32_t delay_cost(size_t flight) const;
+
+    // First position of runway_i whose flight starts at or after time (start times grow along a runway)
+    size_t first_position_after(size_t runway_i, uint32_t time) const;
+
+    // Start times from position to the end of runway_i, updating the objective. Stops at the first flight from
+    // changed_end on whose start time does not change.
+    void reschedule(size_t runway_i, size_t position, size_t changed_end);
+
+    // Objective change of inserting flight at position of runway_i (nothing is modified)
+    int64_t insertion_delta(size_t runway_i, size_t position, size_t flight) const;
+
+    void cheapest_insertion(size_t flight);
+    void unschedule(size_t flight);
+
+    // RVND and ILS on the flights around time, returns whether the schedule improved
+    bool repair_region(uint32_t time);
+
+public:
+    size_t region_size = 40;        // Flights of the window repaired after each change
+    size_t max_ils_iterations = 10; // ILS iterations without improvement of a repair
+    double time_limit = 0;          // Seconds a repair may run (0 = no limit)
+
+    explicit OnlineASP(const Instance &instance, uint64_t seed = 0);
+    OnlineASP(const OnlineASP &) = delete;
+    OnlineASP &operator=(const OnlineASP &) = delete;
+
+    void insert(size_t flight);
+    void update(size_t flight, uint32_t release_time);
+    void remove(size_t flight);
+    void apply(const FlightEvent &event);
+
+    const std::vector<std::vector<size_t>> &runways() const { return m_runways; }
+    uint32_t start_time(size_t flight) const { return m_start_times[flight]; }
+    bool is_scheduled(size_t flight) const { return m_scheduled[flight]; }
+    size_t objective() const { return m_objective; }
+
+    // Start times and objective recomputed from scratch
+    bool test_schedule() const;
+
+    void print_runway() const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** pseudo-random generator (Blackman and Vigna), seeded through splitmix64.
+// Satisfies UniformRandomBitGenerator, so it also works with the <random> distributions.
+class Xoshiro256 {
+private:
+    std::array<uint64_t, 4> m_state{};
+
+    static uint64_t rotl(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(const uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        for (uint64_t &word : m_state) {
+            seed += 0x9e3779b97f4a7c15ULL;
+
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    // Raw state, to save and restore a generator exactly
+    const std::array<uint64_t, 4> &state() const { return m_state; }
+    void set_state(const std::array<uint64_t, 4> &state) { m_state = state; }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    // Uniform integer in [0, n) by multiply-shift (Lemire), without the division of a modulo
+    uint64_t bounded(const uint64_t n) {
+        __extension__ typedef unsigned __int128 uint128; // Not ISO C++, hence -pedantic needs the __extension__
+        return static_cast<uint64_t>((static_cast<uint128>((*this)()) * n) >> 64);
+    }
+
+    // Uniform double in [0, 1) from the 53 high bits
+    double canonical() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+};
+
+#endif
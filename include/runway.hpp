@@ -4,15 +4,34 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include "flight.hpp"
 #include "instance.hpp"
 
+// Zobrist-style hash of the link predecessor -> flight (predecessor NO_PREDECESSOR for the first flight of a runway).
+// A solution hashes to the XOR of its links, which does not depend on the runways' labels.
+constexpr size_t NO_PREDECESSOR = std::numeric_limits<size_t>::max();
+
+inline uint64_t hash_link(size_t predecessor, size_t flight) {
+    // splitmix64 finalizer
+    uint64_t key = ((static_cast<uint64_t>(predecessor) + 1) << 32) ^ static_cast<uint64_t>(flight);
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
 class Runway {
 private:
     size_t m_id;
 
+    // Penalty of the schedule continued from position, given the flight that precedes it and its start time.
+    // Stops as soon as the penalty reaches bound.
+    uint32_t propagate_penalty(const Instance &instance, size_t position, const Flight &prev_flight,
+                               uint32_t prev_start_time, uint32_t penalty,
+                               uint32_t bound = std::numeric_limits<uint32_t>::max()) const;
+
 public:
     std::vector<std::reference_wrapper<Flight>> sequence;
     std::vector<uint32_t> prefix_penalty;
@@ -28,6 +47,34 @@ public:
 
     void update_total_penalty(const Instance &instance);
 
+    // Penalty of the runway if the flight at position were replaced by flight (nothing is modified).
+    // Any result >= bound only means that the penalty is not lower than bound.
+    uint32_t replacement_penalty(const Instance &instance, size_t position, const Flight &flight,
+                                 uint32_t bound = std::numeric_limits<uint32_t>::max()) const;
+
+    // Penalty of the runway if flight were inserted at position (nothing is modified)
+    uint32_t insertion_penalty(const Instance &instance, size_t position, const Flight &flight) const;
+
+    // Penalty of the runway if the flight at position were removed (nothing is modified)
+    uint32_t removal_penalty(const Instance &instance, size_t position) const;
+
+    // Recompute start times, positions and prefix penalties from position to the end of the sequence
+    void update_schedule(const Instance &instance, size_t position);
+
+    // Hash of the link into position, from the previous flight or from the start of the runway
+    uint64_t link_hash(size_t position) const;
+
+    // Hash of the links into and out of position
+    uint64_t neighbors_hash(size_t position) const;
+
+    // Hash change of removing the flight at position, which is also the change of inserting it back there
+    uint64_t removal_hash(size_t position) const;
+
+    // Hash of the links changed by swapping the flights at position_i and position_j
+    uint64_t swap_hash(size_t position_i, size_t position_j) const;
+
+    uint64_t calculate_hash() const;
+
     bool test_sequence_feasibility(const Instance &instance) const;
 
     bool test_penalty(const Instance &instance) const;
@@ -2,6 +2,7 @@
 #define SOLUTION_HPP
 
 #include <cstdint>
+#include <filesystem>
 #include <vector>
 
 #include "instance.hpp"
@@ -10,6 +11,7 @@
 struct Solution {
     std::vector<Runway> runways;
     size_t objective = 0;
+    uint64_t hash = 0; // XOR of the runways' link hashes, kept up to date by the local search moves
 
     Solution() = default;
 
@@ -21,6 +23,22 @@ struct Solution {
 
     bool test_feasibility(const Instance &instance) const;
 
+    uint64_t calculate_hash() const;
+
+    void update_hash();
+
+    bool test_hash() const { return hash == calculate_hash(); }
+
+    // Flight ids of each runway in order, independent of the flight vector the solution is bound to
+    void get_sequences(std::vector<std::vector<size_t>> &sequences) const;
+
+    // Machine-readable output: a line "num_runways objective", then one line per runway with its number of flights
+    // followed by a "flight start_time" pair per flight (flights numbered from 1, as printed by print_runway)
+    void write(const std::filesystem::path &solution_file_path) const;
+
+    // Flight ids (from 0) of each runway of a file written by write, start times are ignored
+    static std::vector<std::vector<size_t>> read_sequences(const std::filesystem::path &solution_file_path);
+
     void print() const;
 
     void print_runway() const;
@@ -0,0 +1,386 @@
+#include "ASP.hpp"
+#include "flight.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+
+namespace {
+
+constexpr size_t NUM_DESTROY_OPERATORS = 4;
+constexpr size_t NUM_REPAIR_OPERATORS = 3;
+
+constexpr size_t SEGMENT_SIZE = 100;    // Iterations between two weight updates
+constexpr double REACTION_FACTOR = 0.1; // How much the scores of the last segment change the weights
+
+// Scores of an operator pair (Ropke & Pisinger values): a new best above an improvement of the current solution above
+// an accepted worse solution
+constexpr double SCORE_NEW_BEST = 33;
+constexpr double SCORE_IMPROVED = 13;
+constexpr double SCORE_ACCEPTED = 9;
+
+constexpr double WORST_REMOVAL_RANDOMNESS = 3; // 1 is uniform, larger values favor the worst flights
+
+template <size_t N> size_t roulette(const std::array<double, N> &weights, Xoshiro256 &generator) {
+    double total_weight = 0;
+    for (const double weight : weights) {
+        total_weight += weight;
+    }
+    std::uniform_real_distribution<double> dist(0, total_weight);
+    double value = dist(generator);
+
+    for (size_t i = 0; i + 1 < N; ++i) {
+        if (value < weights[i]) return i;
+        value -= weights[i];
+    }
+    return N - 1;
+}
+
+template <size_t N>
+void update_weights(std::array<double, N> &weights, std::array<double, N> &scores, std::array<size_t, N> &uses) {
+    for (size_t i = 0; i < N; ++i) {
+        if (uses[i] > 0) {
+            weights[i] = ((1 - REACTION_FACTOR) * weights[i]) + (REACTION_FACTOR * scores[i] / uses[i]);
+        }
+    }
+    scores.fill(0);
+    uses.fill(0);
+}
+
+} // namespace
+
+void ASP::destroy(Solution &solution, const Destroy destroy_operator, size_t num_flights) {
+    const size_t num_runways = m_instance.get_num_runways();
+
+    m_removed_flights.clear();
+    m_is_removed.assign(m_instance.get_num_flights(), false);
+    m_remaining_flights.resize(num_runways);
+    m_destroy_candidates.clear();
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        m_remaining_flights[runway_i] = solution.runways[runway_i].sequence.size();
+
+        for (const auto &flight : solution.runways[runway_i].sequence) {
+            m_destroy_candidates.push_back(flight);
+        }
+    }
+
+    // Every runway keeps at least one flight
+    num_flights = std::min(num_flights, m_destroy_candidates.size() - std::min(num_runways, m_destroy_candidates.size()));
+
+    auto remove = [&](Flight &flight) {
+        if (m_is_removed[flight.get_id()] or m_remaining_flights[flight.runway] <= 1) return;
+
+        m_is_removed[flight.get_id()] = true;
+        m_remaining_flights[flight.runway]--;
+        m_removed_flights.emplace_back(flight);
+    };
+
+    switch (destroy_operator) {
+    case Destroy::Random: {
+        for (size_t i = 0; i < m_destroy_candidates.size() and m_removed_flights.size() < num_flights; ++i) {
+            std::uniform_int_distribution<size_t> dist_candidate(i, m_destroy_candidates.size() - 1);
+            std::swap(m_destroy_candidates[i], m_destroy_candidates[dist_candidate(m_generator)]);
+
+            remove(m_destroy_candidates[i]);
+        }
+        break;
+    }
+    case Destroy::TimeWindow: {
+        // Flights that start close to a random flight
+        std::uniform_int_distribution<size_t> dist_candidate(0, m_destroy_candidates.size() - 1);
+        const int anchor_time = m_destroy_candidates[dist_candidate(m_generator)].get().start_time;
+
+        std::sort(m_destroy_candidates.begin(), m_destroy_candidates.end(), [anchor_time](const auto a, const auto b) {
+            return std::abs(a.get().start_time - anchor_time) < std::abs(b.get().start_time - anchor_time);
+        });
+
+        for (size_t i = 0; i < m_destroy_candidates.size() and m_removed_flights.size() < num_flights; ++i) {
+            remove(m_destroy_candidates[i]);
+        }
+        break;
+    }
+    case Destroy::Runway: {
+        // Block of consecutive flights of a random runway
+        std::uniform_int_distribution<size_t> dist_runway(0, num_runways - 1);
+        const Runway &runway = solution.runways[dist_runway(m_generator)];
+
+        if (runway.sequence.size() < 2) break;
+
+        std::uniform_int_distribution<size_t> dist_position(0, runway.sequence.size() - 1);
+
+        for (size_t i = dist_position(m_generator);
+             i < runway.sequence.size() and m_removed_flights.size() < num_flights; ++i) {
+            remove(runway.sequence[i]);
+        }
+        break;
+    }
+    case Destroy::WorstDelay: {
+        // Same score as move_worst_flight, with a randomized choice biased towards the worst flights
+        std::sort(m_destroy_candidates.begin(), m_destroy_candidates.end(), [](const auto a, const auto b) {
+            return a.get().get_delay_cost() > b.get().get_delay_cost();
+        });
+        std::uniform_real_distribution<double> dist(0, 1);
+
+        while (not m_destroy_candidates.empty() and m_removed_flights.size() < num_flights) {
+            const auto candidate_i = static_cast<size_t>(std::pow(dist(m_generator), WORST_REMOVAL_RANDOMNESS) *
+                                                         static_cast<double>(m_destroy_candidates.size()));
+
+            // The last candidate takes its place, the order is only approximate afterwards
+            remove(m_destroy_candidates[candidate_i]);
+            m_destroy_candidates[candidate_i] = m_destroy_candidates.back();
+            m_destroy_candidates.pop_back();
+        }
+        break;
+    }
+    }
+
+    // Take the removed flights out of the runways
+    solution.objective = 0;
+
+    for (Runway &runway : solution.runways) {
+        size_t first_removed = runway.sequence.size();
+        size_t size = 0;
+
+        for (size_t k = 0; k < runway.sequence.size(); ++k) {
+            if (m_is_removed[runway.sequence[k].get().get_id()]) {
+                first_removed = std::min(first_removed, k);
+            } else {
+                runway.sequence[size++] = runway.sequence[k];
+            }
+        }
+
+        if (first_removed < runway.sequence.size()) {
+            runway.sequence.erase(runway.sequence.begin() + static_cast<long>(size), runway.sequence.end());
+            runway.update_schedule(m_instance, first_removed);
+        }
+        solution.objective += runway.penalty;
+    }
+}
+
+void ASP::update_insertion_cost(const Solution &solution, const size_t removed_i, const size_t runway_i) {
+    const Runway &runway = solution.runways[runway_i];
+    const Flight &flight = m_removed_flights[removed_i].get();
+
+    uint32_t best_cost = std::numeric_limits<uint32_t>::max();
+    size_t best_position = 0;
+
+    for (size_t position = 0; position <= runway.sequence.size(); ++position) {
+        const uint32_t cost = runway.insertion_penalty(m_instance, position, flight) - runway.penalty;
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_position = position;
+        }
+    }
+    m_insertion_costs[(removed_i * m_instance.get_num_runways()) + runway_i] = best_cost;
+    m_insertion_positions[(removed_i * m_instance.get_num_runways()) + runway_i] = best_position;
+}
+
+void ASP::repair(Solution &solution, const Repair repair_operator) {
+    size_t regret_k = 1;
+    if (repair_operator == Repair::Regret2) regret_k = 2;
+    if (repair_operator == Repair::Regret3) regret_k = 3;
+
+    insert_removed_flights(solution, regret_k);
+}
+
+void ASP::insert_removed_flights(Solution &solution, size_t regret_k) {
+    const size_t num_runways = m_instance.get_num_runways();
+    regret_k = std::clamp<size_t>(regret_k, 1, num_runways);
+
+    m_insertion_costs.resize(m_removed_flights.size() * num_runways);
+    m_insertion_positions.resize(m_removed_flights.size() * num_runways);
+    m_regret_costs.resize(num_runways);
+
+    for (size_t removed_i = 0; removed_i < m_removed_flights.size(); ++removed_i) {
+        for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+            update_insertion_cost(solution, removed_i, runway_i);
+        }
+    }
+
+    // The neighborhoods never empty a runway nor expect one empty, so the last flights fill the empty ones
+    size_t empty_runways = 0;
+    for (const Runway &runway : solution.runways) {
+        if (runway.sequence.empty()) ++empty_runways;
+    }
+
+    while (not m_removed_flights.empty()) {
+        size_t selected_i = 0;
+        size_t selected_runway = 0;
+        uint32_t selected_cost = std::numeric_limits<uint32_t>::max();
+        uint64_t selected_regret = 0;
+        const bool fill_empty_runways = m_removed_flights.size() <= empty_runways;
+
+        for (size_t removed_i = 0; removed_i < m_removed_flights.size(); ++removed_i) {
+            const uint32_t *costs = &m_insertion_costs[removed_i * num_runways];
+
+            if (fill_empty_runways) {
+                // Cheapest insertion on an empty runway
+                for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+                    if (solution.runways[runway_i].sequence.empty() and costs[runway_i] < selected_cost) {
+                        selected_i = removed_i;
+                        selected_runway = runway_i;
+                        selected_cost = costs[runway_i];
+                    }
+                }
+                continue;
+            }
+
+            const size_t best_runway = static_cast<size_t>(std::min_element(costs, costs + num_runways) - costs);
+            const uint32_t best_cost = costs[best_runway];
+
+            // Regret := sum of the differences between the best and the next k - 1 best runways
+            uint64_t regret = 0;
+
+            if (regret_k > 1) {
+                std::copy(costs, costs + num_runways, m_regret_costs.begin());
+                std::partial_sort(m_regret_costs.begin(), m_regret_costs.begin() + static_cast<long>(regret_k),
+                                  m_regret_costs.end());
+
+                for (size_t h = 1; h < regret_k; ++h) {
+                    regret += m_regret_costs[h] - best_cost;
+                }
+            }
+
+            if (regret > selected_regret or (regret == selected_regret and best_cost < selected_cost)) {
+                selected_i = removed_i;
+                selected_runway = best_runway;
+                selected_cost = best_cost;
+                selected_regret = regret;
+            }
+        }
+
+        // Insert the selected flight at its best position
+        Runway &runway = solution.runways[selected_runway];
+        const size_t position = m_insertion_positions[(selected_i * num_runways) + selected_runway];
+        if (runway.sequence.empty()) --empty_runways;
+
+        runway.sequence.insert(runway.sequence.begin() + static_cast<long>(position), m_removed_flights[selected_i]);
+        runway.update_schedule(m_instance, position);
+        solution.objective += selected_cost;
+
+        // Remove it from the removed flights (the last one takes its place)
+        const size_t last_i = m_removed_flights.size() - 1;
+
+        m_removed_flights[selected_i] = m_removed_flights[last_i];
+        std::copy_n(&m_insertion_costs[last_i * num_runways], num_runways,
+                    &m_insertion_costs[selected_i * num_runways]);
+        std::copy_n(&m_insertion_positions[last_i * num_runways], num_runways,
+                    &m_insertion_positions[selected_i * num_runways]);
+        m_removed_flights.pop_back();
+
+        // Only the insertion costs on the runway that changed are outdated
+        for (size_t removed_i = 0; removed_i < m_removed_flights.size(); ++removed_i) {
+            update_insertion_cost(solution, removed_i, selected_runway);
+        }
+    }
+    solution.update_hash();
+    assert(solution.test_feasibility(m_instance));
+}
+
+Solution ASP::ALNS(const size_t max_iterations, const double destroy_ratio) { // NOLINT
+    std::cout << ">> ALNS\n";
+
+    start_clock();
+
+    Solution current = construct(flights);
+    Solution best_found; // Bound to m_best_flights, current goes on rescheduling flights
+    copy_solution(best_found, current, m_best_flights);
+    update_time_to_best(best_found.objective);
+    Solution solution; // Destroyed and repaired copy of current, bound to flights_perturbation
+
+    std::cout << "Initial solution: " << current.objective << '\n';
+
+    start_trace();
+    m_iteration = 0;
+    trace(0, current.objective);
+
+    std::array<double, NUM_DESTROY_OPERATORS> destroy_weights{};
+    std::array<double, NUM_DESTROY_OPERATORS> destroy_scores{};
+    std::array<size_t, NUM_DESTROY_OPERATORS> destroy_uses{};
+    std::array<double, NUM_REPAIR_OPERATORS> repair_weights{};
+    std::array<double, NUM_REPAIR_OPERATORS> repair_scores{};
+    std::array<size_t, NUM_REPAIR_OPERATORS> repair_uses{};
+
+    destroy_weights.fill(1);
+    repair_weights.fill(1);
+
+    const auto max_removed = std::max<size_t>(
+        1, static_cast<size_t>(std::ceil(destroy_ratio * static_cast<double>(m_instance.get_num_flights()))));
+    std::uniform_int_distribution<size_t> dist_removed(1, max_removed);
+
+    // Worse solutions are accepted as in the ILS, by simulated annealing (Ropke & Pisinger) if it is strict
+    const Acceptance criterion = acceptance == Acceptance::Strict ? Acceptance::SimulatedAnnealing : acceptance;
+    m_late_acceptance.assign(std::max<size_t>(1, late_acceptance_length), current.objective);
+    m_acceptance_iteration = 0;
+
+    for (size_t iteration = 1; iteration <= max_iterations and not time_expired(); ++iteration) {
+        m_iteration = iteration;
+        copy_solution(solution, current, flights_perturbation);
+
+        const size_t destroy_i = roulette(destroy_weights, m_generator);
+        const size_t repair_i = roulette(repair_weights, m_generator);
+
+        destroy(solution, static_cast<Destroy>(destroy_i), dist_removed(m_generator));
+        repair(solution, static_cast<Repair>(repair_i));
+
+        double progress = static_cast<double>(iteration) / static_cast<double>(max_iterations);
+        if (time_limit > 0) {
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+            progress = std::min(1.0, elapsed / time_limit);
+        }
+
+        double score = 0;
+
+        if (accept(criterion, solution.objective, current.objective, best_found.objective, progress)) {
+            if (solution.objective < best_found.objective) {
+                score = SCORE_NEW_BEST;
+            } else if (solution.objective < current.objective) {
+                score = SCORE_IMPROVED;
+            } else if (solution.objective > current.objective) {
+                score = SCORE_ACCEPTED;
+            }
+            const bool changed = solution.objective != current.objective;
+            copy_solution(current, solution, flights);
+
+            if (current.objective < best_found.objective) {
+                copy_solution(best_found, current, m_best_flights);
+                update_time_to_best(best_found.objective);
+            }
+            if (changed) trace(0, current.objective);
+        }
+
+        destroy_scores[destroy_i] += score;
+        destroy_uses[destroy_i]++;
+        repair_scores[repair_i] += score;
+        repair_uses[repair_i]++;
+
+        if (iteration % SEGMENT_SIZE == 0) {
+            update_weights(destroy_weights, destroy_scores, destroy_uses);
+            update_weights(repair_weights, repair_scores, repair_uses);
+        }
+    }
+
+    m_tracing = false;
+
+    std::cout << "\nDestroy weights (random, time window, runway, worst delay):";
+    for (const double weight : destroy_weights) {
+        std::cout << ' ' << weight;
+    }
+    std::cout << "\nRepair weights (greedy, regret-2, regret-3):";
+    for (const double weight : repair_weights) {
+        std::cout << ' ' << weight;
+    }
+    std::cout << "\n\nBest found: " << best_found.objective << '\n';
+
+    return best_found;
+}
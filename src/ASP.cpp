@@ -1,15 +1,218 @@
 #include "ASP.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cstdlib>
-#include <random>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 
-ASP::ASP(Instance &instance) : m_instance(instance) {
-    std::random_device rd;
-    m_generator = std::mt19937(rd());
+ASP::ASP(const Instance &instance, const uint64_t seed) : m_instance(instance), m_generator(seed) { reload_instance(); }
+
+void ASP::reload_instance() {
+    flights.clear();
+    flights_perturbation.clear();
 
     for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
         flights.emplace_back(i, m_instance.get_release_time(i), m_instance.get_runway_occupancy_time(i),
                              m_instance.get_delay_penalty(i));
         flights_perturbation.emplace_back(i, m_instance.get_release_time(i), m_instance.get_runway_occupancy_time(i),
-                             m_instance.get_delay_penalty(i));                     
+                                          m_instance.get_delay_penalty(i));
+    }
+    m_incumbent_flights = flights;
+    m_best_flights = flights;
+
+    // Flights whose start times are within one average runway occupancy time compete for the same time slot
+    uint64_t total_runway_occupancy_time = 0;
+    for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
+        total_runway_occupancy_time += m_instance.get_runway_occupancy_time(i);
+    }
+    m_slot_window = 0;
+    if (m_instance.get_num_flights() > 0) {
+        m_slot_window = static_cast<uint32_t>(total_runway_occupancy_time / m_instance.get_num_flights());
+    }
+
+    // The hashes of another instance's local optima would stop RVND on solutions it never reached
+    clear_visited_optima();
+}
+
+void ASP::copy_solution(Solution &target, const Solution &source, std::vector<Flight> &target_flights) {
+    if (target.runways.size() != source.runways.size()) {
+        target.runways = source.runways;
+    }
+    target.objective = source.objective;
+
+    for (size_t i = 0; i < source.runways.size(); ++i) {
+        Runway &runway = target.runways[i];
+
+        runway.sequence.clear();
+
+        for (const auto &flight : source.runways[i].sequence) {
+            runway.sequence.emplace_back(target_flights[flight.get().get_id()]);
+        }
+        runway.update_schedule(m_instance, 0);
+    }
+    target.update_hash();
+    assert(target.test_feasibility(m_instance));
+}
+
+void ASP::load_solution(Solution &target, const std::vector<std::vector<size_t>> &sequences,
+                        std::vector<Flight> &target_flights) {
+    if (target.runways.size() != sequences.size()) {
+        target = Solution(m_instance);
+    }
+    target.objective = 0;
+
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        Runway &runway = target.runways[i];
+
+        runway.sequence.clear();
+
+        for (const size_t flight_id : sequences[i]) {
+            runway.sequence.emplace_back(target_flights[flight_id]);
+        }
+        runway.update_schedule(m_instance, 0);
+        target.objective += runway.penalty;
+    }
+    target.update_hash();
+    assert(target.test_feasibility(m_instance));
+}
+
+Solution ASP::warm_start(const std::vector<std::vector<size_t>> &sequences, std::vector<Flight> &target_flights) {
+    if (sequences.size() != m_instance.get_num_runways()) {
+        throw std::runtime_error("Initial solution and instance have different numbers of runways");
+    }
+
+    Solution solution(m_instance);
+    std::vector<bool> scheduled(m_instance.get_num_flights(), false);
+
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        Runway &runway = solution.runways[i];
+
+        for (const size_t flight_id : sequences[i]) {
+            if (flight_id >= m_instance.get_num_flights() or scheduled[flight_id]) continue;
+
+            runway.sequence.emplace_back(target_flights[flight_id]);
+            scheduled[flight_id] = true;
+        }
+        runway.update_schedule(m_instance, 0);
+    }
+
+    // Flights of the instance that the previous schedule did not have
+    for (size_t flight_id = 0; flight_id < m_instance.get_num_flights(); ++flight_id) {
+        if (scheduled[flight_id]) continue;
+
+        Flight &flight = target_flights[flight_id];
+        int64_t best_delta = std::numeric_limits<int64_t>::max();
+        size_t best_runway_i = 0;
+        size_t best_position = 0;
+
+        for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+            const Runway &runway = solution.runways[runway_i];
+
+            for (size_t position = 0; position <= runway.sequence.size(); ++position) {
+                const int64_t delta =
+                    static_cast<int64_t>(runway.insertion_penalty(m_instance, position, flight)) - runway.penalty;
+
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_runway_i = runway_i;
+                    best_position = position;
+                }
+            }
+        }
+        Runway &runway = solution.runways[best_runway_i];
+        runway.sequence.insert(runway.sequence.begin() + static_cast<std::ptrdiff_t>(best_position), flight);
+        runway.update_schedule(m_instance, best_position);
+    }
+
+    for (const Runway &runway : solution.runways) {
+        solution.objective += runway.penalty;
+    }
+    solution.update_hash();
+    assert(solution.test_feasibility(m_instance));
+
+    return solution;
+}
+
+const std::vector<ASP::Move> &ASP::select_moves() {
+    m_selected_moves.clear();
+
+    for (const Move &move : m_moves) {
+        if (move.delta > 0) {
+            m_selected_moves.push_back(move);
+        }
+    }
+    std::stable_sort(m_selected_moves.begin(), m_selected_moves.end(),
+                     [](const Move &a, const Move &b) { return a.delta > b.delta; });
+
+    if (!multi_move) {
+        if (m_selected_moves.size() > 1) m_selected_moves.resize(1);
+    } else {
+        m_runway_touched.assign(m_instance.get_num_runways(), false);
+
+        auto selected_end = m_selected_moves.begin();
+        for (const Move &move : m_selected_moves) {
+            if (m_runway_touched[move.runway_i] || m_runway_touched[move.runway_j]) continue;
+
+            m_runway_touched[move.runway_i] = true;
+            m_runway_touched[move.runway_j] = true;
+            *selected_end++ = move;
+        }
+        m_selected_moves.erase(selected_end, m_selected_moves.end());
+    }
+
+    if (!m_selected_moves.empty()) {
+        m_improving_passes++;
+        m_applied_moves += m_selected_moves.size();
+    }
+    return m_selected_moves;
+}
+
+double ASP::revisit_rate() const {
+    if (m_local_searches == 0) return 0;
+    return static_cast<double>(m_revisits) / static_cast<double>(m_local_searches);
+}
+
+double ASP::moves_per_pass() const {
+    if (m_improving_passes == 0) return 0;
+    return static_cast<double>(m_applied_moves) / static_cast<double>(m_improving_passes);
+}
+
+void ASP::start_clock() {
+    m_start_time = std::chrono::steady_clock::now();
+    m_deadline = m_start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(time_limit));
+    m_best_objective = std::numeric_limits<size_t>::max();
+    m_time_to_best = 0;
+    m_time_to_target = -1;
+}
+
+void ASP::update_time_to_best(const size_t objective) {
+    if (objective < m_best_objective) {
+        m_best_objective = objective;
+        m_time_to_best = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+
+        if (objective <= target_objective and m_time_to_target < 0) m_time_to_target = m_time_to_best;
+    }
+}
+
+void ASP::merge_statistics(const ASP &worker) {
+    for (size_t i = 0; i < NUM_NEIGHBORHOODS; ++i) {
+        const NeighborhoodStatistics &worker_statistics = worker.m_neighborhood_statistics[i];
+        NeighborhoodStatistics &statistics = m_neighborhood_statistics[i];
+
+        statistics.calls += worker_statistics.calls;
+        statistics.improvements += worker_statistics.improvements;
+        statistics.total_gain += worker_statistics.total_gain;
+        statistics.total_time_us += worker_statistics.total_time_us;
+        statistics.total_reward += worker_statistics.total_reward;
     }
+    m_neighborhood_calls += worker.m_neighborhood_calls;
+    m_local_searches += worker.m_local_searches;
+    m_revisits += worker.m_revisits;
+    m_improving_passes += worker.m_improving_passes;
+    m_applied_moves += worker.m_applied_moves;
+    m_accepted_worse += worker.m_accepted_worse;
+    add_operator_statistics(worker.m_operator_statistics);
 }
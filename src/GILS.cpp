@@ -1,40 +1,63 @@
 #include "ASP.hpp"
 #include "flight.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
 #include <limits>
 #include <omp.h>
 #include <sys/types.h>
+#include <vector>
+
+namespace {
+
+constexpr double ANNEALING_FINAL_RATIO = 0.01; // Final temperature of the annealing, relative to the initial one
+
+// Starting solution of a batch, kept as flight ids until the best one is known
+struct BatchCandidate {
+    std::vector<std::vector<size_t>> sequences;
+    size_t objective = 0;
+    Xoshiro256 generator;
+};
+
+} // namespace
 
 Solution ASP::parallel_GILS_VND(const size_t max_iterations, const size_t max_ils_iterations, const float alpha) {
     Solution best_found;
     best_found.objective = std::numeric_limits<uint32_t>::max();
 
+    start_clock();
+
+    std::vector<uint64_t> seeds(static_cast<size_t>(omp_get_max_threads()));
+    for (uint64_t &seed : seeds) {
+        seed = m_generator();
+    }
+    size_t best_thread = seeds.size();
+
 #pragma omp parallel
     {
-        std::vector<Flight> flights;
+        // Each worker owns its flights, scratch buffers and generator, only the instance is shared
+        ASP worker = *this;
+        worker.m_generator.seed(seeds[static_cast<size_t>(omp_get_thread_num())]);
 
-        flights.reserve(m_instance.get_num_flights());
-
-        for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
-            flights.emplace_back(i, m_instance.get_release_time(i), m_instance.get_runway_occupancy_time(i),
-                                 m_instance.get_delay_penalty(i));
-        }
+#pragma omp barrier
 
         Solution local_best;
         local_best.objective = std::numeric_limits<uint32_t>::max();
 
 #pragma omp for nowait
         for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+            if (worker.time_expired() and local_best.objective != std::numeric_limits<uint32_t>::max()) continue;
 
-            Solution solution = lowest_release_time_insertion(flights);
+            Solution solution = worker.lowest_release_time_insertion(worker.flights);
             Solution iteration_best = solution;
 
             size_t ils_iteration = 0;
-            while (ils_iteration <= max_ils_iterations) {
-                VND(solution);
+            while (ils_iteration <= max_ils_iterations and not worker.time_expired()) {
+                worker.VND(solution);
 
                 if (solution.objective < iteration_best.objective) {
                     iteration_best = solution;
@@ -48,11 +71,18 @@ Solution ASP::parallel_GILS_VND(const size_t max_iterations, const size_t max_il
             }
         }
 
-#pragma omp critical
+#pragma omp critical(best_board)
         {
-            if (local_best.objective < best_found.objective) {
-                best_found = local_best;
+            // Ties go to the lowest thread, so the result does not depend on the order the threads finish in
+            const auto thread = static_cast<size_t>(omp_get_thread_num());
+
+            if (local_best.objective < best_found.objective or
+                (local_best.objective == best_found.objective and thread < best_thread)) {
+                copy_solution(best_found, local_best, flights);
+                update_time_to_best(best_found.objective);
+                best_thread = thread;
             }
+            merge_statistics(worker);
         }
     }
     return best_found;
@@ -62,16 +92,19 @@ Solution ASP::GILS_VND(const size_t max_iterations, const size_t max_ils_iterati
     Solution best_found;
     best_found.objective = std::numeric_limits<uint32_t>::max();
 
+    start_clock();
+
     for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
         Solution solution = rand_lowest_release_time_insertion(flights);
 
         Solution local_best = solution;
 
         VND(solution);
+        update_time_to_best(solution.objective);
 
         size_t ils_iteration = 1;
 
-        while (ils_iteration <= max_ils_iterations) {
+        while (ils_iteration <= max_ils_iterations and not time_expired()) {
             size_t max_pertubation_iters =
                 1 + static_cast<size_t>(std::ceil(alpha * static_cast<double>(m_instance.get_num_runways() / 2)));
 
@@ -84,6 +117,7 @@ Solution ASP::GILS_VND(const size_t max_iterations, const size_t max_ils_iterati
 
             if (solution.objective < local_best.objective) {
                 local_best = solution;
+                update_time_to_best(local_best.objective);
                 ils_iteration = 0;
             }
             ++ils_iteration;
@@ -92,116 +126,353 @@ Solution ASP::GILS_VND(const size_t max_iterations, const size_t max_ils_iterati
         if (local_best.objective < best_found.objective) {
             best_found = local_best;
         }
+        if (time_expired()) break;
     }
     return best_found;
 }
 
+void ASP::perturb(Solution &solution, const size_t ils_iteration, const size_t extra_strength) {
+    size_t max_pertubation_iters =
+        1 /* + static_cast<size_t>(std::ceil(alpha * static_cast<double>(m_instance.get_num_runways() / 2))) */;
+
+    if (ils_iteration < 2000) max_pertubation_iters += ils_iteration / (2000 / m_instance.get_num_runways());
+    else max_pertubation_iters += (ils_iteration - 2000) / (2000 / m_instance.get_num_runways());
+
+    for (size_t perturbation_iteration = 1; perturbation_iteration <= max_pertubation_iters;
+         ++perturbation_iteration) {
+
+        if (ils_iteration > 2000) P4(solution);
+        else random_inter_block_swap(solution);
+    }
+    for (size_t perturbation_iteration = 1; perturbation_iteration <= extra_strength; ++perturbation_iteration) {
+        random_inter_block_swap(solution);
+    }
+}
+
+bool ASP::accept(const Acceptance criterion, const size_t candidate, const size_t current, const size_t best,
+                 const double progress) {
+    bool accepted = candidate <= current;
+
+    switch (criterion) {
+    case Acceptance::Strict:
+        accepted = candidate < current;
+        break;
+    case Acceptance::Threshold: {
+        // Threshold accepting, the threshold shrinks linearly to strict acceptance
+        const double threshold = acceptance_ratio * static_cast<double>(best) * (1 - progress);
+        accepted = static_cast<double>(candidate) < static_cast<double>(current) + threshold;
+        break;
+    }
+    case Acceptance::LateAcceptance: {
+        // Late acceptance hill climbing: compare with the incumbent of late_acceptance_length iterations ago
+        size_t &late = m_late_acceptance[m_acceptance_iteration++ % m_late_acceptance.size()];
+
+        accepted = accepted or candidate <= late;
+        late = accepted ? candidate : current;
+        break;
+    }
+    case Acceptance::SimulatedAnnealing: {
+        // Geometric cooling from acceptance_ratio * best down to a hundredth of it
+        const double temperature =
+            acceptance_ratio * static_cast<double>(best) * std::pow(ANNEALING_FINAL_RATIO, progress);
+
+        accepted = accepted or (temperature > 0 and
+                                m_generator.canonical() <
+                                    std::exp(-static_cast<double>(candidate - current) / temperature));
+        break;
+    }
+    }
+
+    if (accepted and candidate > current) m_accepted_worse++;
+    return accepted;
+}
+
+size_t ASP::ILS_RVND(Solution &local_best, const size_t max_ils_iterations, size_t budget, // NOLINT
+                     size_t ils_iteration) {
+    size_t revisits = 0; // Consecutive iterations that fell back into a known local optimum
+
+    Solution solution; // Perturbed copy of the incumbent, bound to flights_perturbation
+
+    // Strict acceptance only moves to a new local best, so local_best is the incumbent
+    const bool strict = acceptance == Acceptance::Strict;
+    Solution incumbent; // Bound to m_incumbent_flights
+    if (not strict) {
+        copy_solution(incumbent, local_best, m_incumbent_flights);
+        m_late_acceptance.assign(std::max<size_t>(1, late_acceptance_length), local_best.objective);
+        m_acceptance_iteration = 0;
+    }
+    if (m_resume_pending) {
+        // Continue the ILS interrupted by the checkpoint
+        ils_iteration = m_checkpoint.ils_iteration;
+        revisits = m_checkpoint.revisits;
+
+        if (not strict and not m_checkpoint.incumbent.empty()) {
+            load_solution(incumbent, m_checkpoint.incumbent, m_incumbent_flights);
+            if (not m_checkpoint.late_acceptance.empty()) m_late_acceptance = m_checkpoint.late_acceptance;
+            m_acceptance_iteration = m_checkpoint.acceptance_iteration;
+        }
+        m_resume_pending = false;
+    }
+    Solution &current = strict ? local_best : incumbent;
+
+    // Schedule of the threshold and the temperature: share of the time limit elapsed, or else of the ILS
+    // iterations without improvement (so the search heats up again after each new local best)
+    const auto progress = [&]() {
+        if (time_limit > 0) {
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+            return std::min(1.0, elapsed / time_limit);
+        }
+        return static_cast<double>(ils_iteration) / static_cast<double>(std::max<size_t>(1, max_ils_iterations));
+    };
+
+    while (ils_iteration <= max_ils_iterations and budget-- > 0 and not time_expired()) {
+        copy_solution(solution, current, flights_perturbation);
+
+        // if (ils_iteration % 5 == 0) std::cout << "ils = " << ils_iteration << '\n';
+
+        perturb(solution, ils_iteration, revisits);
+
+        RVND(solution);
+        revisits = m_revisited ? revisits + 1 : 0;
+
+        const bool improved = solution.objective < local_best.objective;
+
+        if (improved) {
+            // std::cout << "ils = " << ils_iteration << '\n';
+
+            copy_solution(local_best, solution, flights);
+            update_time_to_best(local_best.objective);
+        }
+        const bool accepted = not strict and accept(acceptance, solution.objective, incumbent.objective,
+                                                    local_best.objective, progress());
+        if (accepted) {
+            copy_solution(incumbent, solution, m_incumbent_flights);
+        }
+        if (improved or accepted) trace(ils_iteration, current.objective);
+
+        ils_iteration = improved ? 1 : ils_iteration + 1;
+
+        if (m_checkpointing) checkpoint(local_best, strict ? nullptr : &incumbent, ils_iteration, revisits);
+    }
+    return ils_iteration;
+}
+
+void ASP::improve(Solution &solution, const size_t max_ils_iterations) {
+    start_clock();
+    RVND(solution);
+    update_time_to_best(solution.objective);
+    ILS_RVND(solution, max_ils_iterations);
+}
+
+void ASP::batch_construct(Solution &local_best, std::vector<ASP> &workers) {
+    std::vector<BatchCandidate> candidates(std::max<size_t>(1, construction_batch));
+    for (BatchCandidate &candidate : candidates) {
+        candidate.generator.seed(m_generator());
+    }
+
+#pragma omp parallel num_threads(static_cast<int>(workers.size()))
+    {
+        ASP &worker = workers[static_cast<size_t>(omp_get_thread_num())];
+        Solution solution;
+
+        // The first candidate comes from the selected construction, the others alternate between both lowest
+        // release time insertions
+#pragma omp for schedule(static)
+        for (size_t candidate_i = 0; candidate_i < candidates.size(); ++candidate_i) {
+            BatchCandidate &candidate = candidates[candidate_i];
+            std::swap(worker.m_generator, candidate.generator);
+
+            if (candidate_i == 0) {
+                solution = worker.construct(worker.flights);
+            } else if (candidate_i % 2 == 1) {
+                solution = worker.rand_lowest_release_time_insertion(worker.flights);
+            } else {
+                solution = worker.lowest_release_time_insertion(worker.flights);
+            }
+            if (screening_calls > 0) worker.RVND(solution, screening_calls);
+
+            std::swap(worker.m_generator, candidate.generator);
+
+            solution.get_sequences(candidate.sequences);
+            candidate.objective = solution.objective;
+        }
+    }
+
+    // The workers serve the next batches too, so their counters are moved here
+    for (ASP &worker : workers) {
+        add_operator_statistics(worker.m_operator_statistics);
+        worker.m_operator_statistics = {};
+    }
+
+    // Ties go to the first candidate, whatever the number of threads
+    const auto best = std::min_element(candidates.begin(), candidates.end(),
+                                       [](const BatchCandidate &a, const BatchCandidate &b) {
+                                           return a.objective < b.objective;
+                                       });
+    load_solution(local_best, best->sequences, flights);
+}
+
 Solution ASP::GILS_RVND(const size_t max_iterations, const size_t max_ils_iterations, const double alpha) { // NOLINT
     Solution best_found;
     best_found.objective = std::numeric_limits<uint32_t>::max();
 
     std::cout << ">> GILS-RVND\n";
 
-    for (size_t iteration = 1; iteration <= max_iterations; ++iteration) {
-
-        std::cout << "\n[" << iteration << "/" << max_iterations << "]" << '\t';
+    start_clock();
 
-        std::cout << "Best found: " << best_found.objective << '\n';
+    size_t first_iteration = 1;
+    m_checkpointing = not checkpoint_file.empty();
+    m_checkpoint_best = &best_found;
+    m_next_checkpoint = m_start_time;
 
-        Solution local_best = rand_lowest_release_time_insertion(flights);
+    if (m_checkpointing and resume and read_checkpoint()) {
+        first_iteration = m_checkpoint.iteration;
+        m_resume_pending = true;
 
-        std::cout << "\tInitial solution: " << local_best.objective << '\n';
+        if (not m_checkpoint.best_found.empty()) {
+            load_solution(best_found, m_checkpoint.best_found, m_best_flights);
+        }
+        // The clock goes on from where the checkpoint left it
+        const auto elapsed = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(m_checkpoint.elapsed));
+        m_start_time -= elapsed;
+        m_deadline -= elapsed;
+        m_next_checkpoint = std::chrono::steady_clock::now();
+
+        std::cout << "Resumed from " << checkpoint_file.string() << " (iteration " << first_iteration << ", "
+                  << m_checkpoint.elapsed << " s)\n";
+    }
 
-        RVND(local_best);
+    // Workers of the batch construction, copied once so that each iteration only pays for the constructions. Their
+    // screening descents are not part of the run statistics, only of the operator counters.
+    std::vector<ASP> batch_workers;
+    if (construction_batch > 1) {
+        const auto num_workers = std::min<size_t>(static_cast<size_t>(omp_get_max_threads()), construction_batch);
 
-        size_t ils_iteration = 1;
+        batch_workers.reserve(num_workers);
+        for (size_t worker_i = 0; worker_i < num_workers; ++worker_i) {
+            batch_workers.push_back(*this);
+            batch_workers.back().m_operator_statistics = {};
+        }
+    }
 
-        Solution solution = lowest_release_time_insertion(flights_perturbation); // USED AT PERTURBATION
-        
-        while (ils_iteration <= max_ils_iterations) {
-            // solution <= local_best ////////////////////////////////////////
-                solution.objective = local_best.objective;
-
-                // Runways
-                for (size_t i = 0; i < local_best.runways.size(); i++) {
-                    // solution.runways[i] <= local_best.runways[i];
-                    solution.runways[i].penalty = local_best.runways[i].penalty;
-                    solution.runways[i].prefix_penalty = local_best.runways[i].prefix_penalty;
-                    
-                    solution.runways[i].sequence.clear();
-
-                    for (size_t j = 0; j < local_best.runways[i].sequence.size(); j++) {
-                        // solution.runways[i].sequence[j] <= lcoal_best.runways[i].sequence[j]
-                        Flight &flight = local_best.runways[i].sequence[j].get();
-
-                        flights_perturbation[flight.get_id()].start_time = flight.start_time;
-                        flights_perturbation[flight.get_id()].runway = flight.runway;
-                        flights_perturbation[flight.get_id()].position = flight.position;
-                        
-                        solution.runways[i].sequence.emplace_back(flights_perturbation[flight.get_id()]);
-                    }
-                }
-            ////////////////////////////////////////////////////////////////////////////
+    // Allocated after the copies above, which do not trace
+    start_trace();
 
-            
-            // if (ils_iteration % 5 == 0) std::cout << "ils = " << ils_iteration << '\n';
+    for (size_t iteration = first_iteration; iteration <= max_iterations; ++iteration) {
+        m_checkpoint.iteration = iteration;
+        m_iteration = iteration;
 
-            size_t max_pertubation_iters =
-                1 /* + static_cast<size_t>(std::ceil(alpha * static_cast<double>(m_instance.get_num_runways() / 2))) */;
-
-            if (ils_iteration < 2000) max_pertubation_iters += ils_iteration / (2000 / m_instance.get_num_runways());
-            else max_pertubation_iters += (ils_iteration - 2000) / (2000 / m_instance.get_num_runways());
+        Solution local_best;
 
-            for (size_t perturbation_iteration = 1; perturbation_iteration <= max_pertubation_iters;
-                 ++perturbation_iteration) {
-                    
-                if (ils_iteration > 2000) P4(solution);
-                else random_inter_block_swap(solution);
+        if (m_resume_pending) {
+            // The interrupted iteration goes on from its local best, RVND already ran on it
+            load_solution(local_best, m_checkpoint.local_best, flights);
+        } else {
+            // The first iteration starts from the initial solution, if any, instead of a construction
+            const bool warm = iteration == 1 and not initial_solution.empty();
+
+            if (warm) {
+                local_best = warm_start(initial_solution, flights);
+            } else if (not batch_workers.empty()) {
+                batch_construct(local_best, batch_workers);
+            } else {
+                local_best = construct(flights);
             }
 
-            RVND(solution);
+            RVND(local_best);
+            update_time_to_best(local_best.objective);
+            trace(0, local_best.objective);
+        }
 
-            if (solution.objective < local_best.objective) {
-                // std::cout << "ils = " << ils_iteration << '\n';
-
-                // local_best <= solution ////////////////////////////////////////
-                    local_best.objective = solution.objective;
-
-                    // Runways
-                    for (size_t i = 0; i < solution.runways.size(); i++) {
-                        // local_best.runways[i] <= solution.runways[i];
-                        local_best.runways[i].penalty = solution.runways[i].penalty;
-                        local_best.runways[i].prefix_penalty = solution.runways[i].prefix_penalty;
-                        
-                        local_best.runways[i].sequence.clear();
-
-                        for (size_t j = 0; j < solution.runways[i].sequence.size(); j++) {
-                            // local_best.runways[i].sequence[j] <= solution.runways[i].sequence[j]
-                            Flight &flight = solution.runways[i].sequence[j].get();
-
-                            flights[flight.get_id()].start_time = flight.start_time;
-                            flights[flight.get_id()].runway = flight.runway;
-                            flights[flight.get_id()].position = flight.position;
-                            
-                            local_best.runways[i].sequence.emplace_back(flights[flight.get_id()]);
-                        }
-                    }
-                ////////////////////////////////////////////////////////////////////////////
+        ILS_RVND(local_best, max_ils_iterations);
 
-                ils_iteration = 0;
+        if (not m_elite_pool.empty() and not time_expired()) {
+            const EliteSolution &guide = m_elite_pool[random_index(m_elite_pool.size())];
+
+            if (path_relinking(local_best, guide)) {
+                update_time_to_best(local_best.objective);
+                trace(0, local_best.objective);
             }
-            ++ils_iteration;
         }
-        std::cout << "\tLocal best solution: " << local_best.objective;
+        add_to_elite_pool(local_best);
+
         if (local_best.objective < best_found.objective) {
-            best_found = local_best;
-            std::cout << "\t(New best solution!)\n\n";
+            copy_solution(best_found, local_best, m_best_flights);
+        }
+
+        if (time_expired()) {
+            std::cout << "Time limit reached\n";
+            break;
+        }
+    }
+    m_checkpointing = false;
+    m_checkpoint_best = nullptr;
+    m_tracing = false;
+
+    std::cout << "\nBest found: " << best_found.objective << '\n';
+    return best_found;
+}
+
+Solution ASP::parallel_GILS_RVND(const size_t max_iterations, const size_t max_ils_iterations, // NOLINT
+                                 const double alpha) {
+    Solution best_found; // Best solution board, bound to flights and guarded by the best_board critical section
+    best_found.objective = std::numeric_limits<uint32_t>::max();
+
+    std::cout << ">> Parallel GILS-RVND (" << omp_get_max_threads() << " threads)\n";
+
+    start_clock();
+
+    std::vector<uint64_t> seeds(static_cast<size_t>(omp_get_max_threads()));
+    for (uint64_t &seed : seeds) {
+        seed = m_generator();
+    }
+    size_t best_iteration = max_iterations;
+
+#pragma omp parallel
+    {
+        // Each worker owns its flights, scratch buffers and generator, only the instance is shared
+        ASP worker = *this;
+        worker.m_generator.seed(seeds[static_cast<size_t>(omp_get_thread_num())]);
 
-            best_found.print_runway();
-            std::cout << "Objective: " << best_found.objective << '\n';
+#pragma omp barrier
+
+        // Started after the copies above, which do not trace. New bests are recorded on the board.
+#pragma omp single
+        start_trace();
+
+        bool published = false;
+
+        // Static schedule and ties broken by iteration: a seed and a thread count always give the same result
+#pragma omp for schedule(static) nowait
+        for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+            if (worker.time_expired() and published) continue;
+
+            Solution local_best = worker.construct(worker.flights);
+
+            worker.RVND(local_best);
+            worker.ILS_RVND(local_best, max_ils_iterations);
+
+#pragma omp critical(best_board)
+            {
+                if (local_best.objective < best_found.objective or
+                    (local_best.objective == best_found.objective and iteration < best_iteration)) {
+                    copy_solution(best_found, local_best, flights);
+                    update_time_to_best(best_found.objective);
+                    best_iteration = iteration;
+
+                    m_iteration = iteration + 1;
+                    trace(0, best_found.objective);
+                }
+            }
+            published = true;
         }
-        std::cout << '\n';
+
+#pragma omp critical(best_board)
+        merge_statistics(worker);
     }
+    m_tracing = false;
+
     std::cout << "\nBest found: " << best_found.objective << '\n';
     return best_found;
 }
@@ -210,17 +481,20 @@ Solution ASP::GILS_VND_2(const size_t max_iterations, const size_t max_ils_itera
     Solution best_found;
     best_found.objective = std::numeric_limits<uint32_t>::max();
 
+    start_clock();
+
     for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
         Solution solution = randomized_greedy(alpha, flights);
 
         Solution local_best = solution;
 
         size_t ils_iteration = 0;
-        while (ils_iteration <= max_ils_iterations) {
+        while (ils_iteration <= max_ils_iterations and not time_expired()) {
             VND(solution);
 
             if (solution.objective < local_best.objective) {
                 local_best = solution;
+                update_time_to_best(local_best.objective);
                 ils_iteration = 0;
             }
             ++ils_iteration;
@@ -228,7 +502,9 @@ Solution ASP::GILS_VND_2(const size_t max_iterations, const size_t max_ils_itera
 
         if (local_best.objective < best_found.objective) {
             best_found = local_best;
+            update_time_to_best(best_found.objective);
         }
+        if (time_expired()) break;
     }
     return best_found;
 }
@@ -8,6 +8,8 @@ Solution ASP::GRASP_VND(const size_t max_iterations) {
     Solution best_solution;
     best_solution.objective = std::numeric_limits<uint32_t>::max();
 
+    start_clock();
+
     for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
         Solution solution = randomized_greedy(0.01, flights);
 
@@ -15,7 +17,9 @@ Solution ASP::GRASP_VND(const size_t max_iterations) {
 
         if (solution.objective < best_solution.objective) {
             best_solution = solution;
+            update_time_to_best(best_solution.objective);
         }
+        if (time_expired()) break;
     }
     assert(best_solution.test_feasibility(m_instance));
 
@@ -1,16 +1,90 @@
 #include "ASP.hpp"
+#include <array>
+#include <bitset>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
 
-void ASP::RVND(Solution &solution) { // NOLINT
-    std::vector<Neighborhood> neighborhoods{Neighborhood::IntraSwap, Neighborhood::InterSwap, Neighborhood::IntraMove,
-                                            Neighborhood::InterMove};
+namespace {
+
+constexpr uint32_t ALL_NEIGHBORHOODS = (1U << ASP::NUM_NEIGHBORHOODS) - 1;
+
+constexpr double UCB_EXPLORATION = 1.4142135623730951; // sqrt(2) of UCB1
+
+} // namespace
+
+ASP::Neighborhood ASP::select_neighborhood(const uint32_t active_neighborhoods) {
+    if (neighborhood_selection == NeighborhoodSelection::Uniform) {
+        // Uniform choice among the active neighborhoods
+        size_t choice = random_index(std::bitset<NUM_NEIGHBORHOODS>(active_neighborhoods).count());
+
+        for (size_t i = 0; i < NUM_NEIGHBORHOODS; ++i) {
+            if ((active_neighborhoods >> i & 1U) != 0 and choice-- == 0) return static_cast<Neighborhood>(i);
+        }
+    }
+
+    // UCB1 over the active neighborhoods, with rewards normalized by the best average reward
+    double best_average_reward = 0;
+    for (const NeighborhoodStatistics &statistics : m_neighborhood_statistics) {
+        if (statistics.calls > 0) {
+            best_average_reward =
+                std::max(best_average_reward, statistics.total_reward / static_cast<double>(statistics.calls));
+        }
+    }
+
+    size_t selected = 0;
+    double best_score = -1;
+
+    for (size_t i = 0; i < NUM_NEIGHBORHOODS; ++i) {
+        if ((active_neighborhoods >> i & 1U) == 0) continue;
+
+        const NeighborhoodStatistics &statistics = m_neighborhood_statistics[i];
+
+        if (statistics.calls == 0) return static_cast<Neighborhood>(i); // Every neighborhood is tried once
+
+        const auto calls = static_cast<double>(statistics.calls);
+        double score = UCB_EXPLORATION * std::sqrt(std::log(static_cast<double>(m_neighborhood_calls)) / calls);
+
+        if (best_average_reward > 0) {
+            score += statistics.total_reward / calls / best_average_reward;
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            selected = i;
+        }
+    }
+    return static_cast<Neighborhood>(selected);
+}
+
+void ASP::RVND(Solution &solution, const size_t max_calls) { // NOLINT
+    uint32_t active_neighborhoods = ALL_NEIGHBORHOODS;
+    size_t calls = 0;
 
     bool improved = false;
-    size_t current_neighborhood = 0;
 
-    while (not neighborhoods.empty()) {
-        current_neighborhood = rand() % neighborhoods.size();
-        switch (neighborhoods[current_neighborhood]) {
+    if (m_visited_optima.empty()) {
+        m_visited_optima.assign(VISITED_OPTIMA_CAPACITY, 0);
+    }
+    m_local_searches++;
+    m_revisited = false;
+
+    while (active_neighborhoods != 0 and calls++ < max_calls and not time_expired()) {
+        // No neighborhood improves a known local optimum, so the final non-improving pass is skipped
+        if (m_visited_optima[solution.hash & (VISITED_OPTIMA_CAPACITY - 1)] == solution.hash) {
+            m_revisited = true;
+            m_revisits++;
+            break;
+        }
+
+        const Neighborhood current_neighborhood = select_neighborhood(active_neighborhoods);
+        const size_t original_objective = solution.objective;
+        const auto start = std::chrono::steady_clock::now();
+
+        switch (current_neighborhood) {
         case Neighborhood::IntraSwap:
             improved = best_improvement_intra_swap(solution);
             // improved = first_improvement_intra_swap(solution);
@@ -27,14 +101,69 @@ void ASP::RVND(Solution &solution) { // NOLINT
             improved = best_improvement_inter_move(solution);
             // improved = first_improvement_inter_move(solution);
             break;
+        case Neighborhood::TimeSlotAssignment:
+            improved = best_improvement_time_slot_assignment(solution);
+            break;
         }
-        if (improved) {
-            neighborhoods = {Neighborhood::IntraSwap, Neighborhood::InterSwap, Neighborhood::IntraMove,
-                             Neighborhood::InterMove};
 
+        if (neighborhood_selection == NeighborhoodSelection::UCB) {
+            const double time_us =
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            const size_t gain = original_objective - solution.objective;
+
+            NeighborhoodStatistics &statistics = m_neighborhood_statistics[static_cast<size_t>(current_neighborhood)];
+            statistics.calls++;
+            statistics.improvements += improved ? 1 : 0;
+            statistics.total_gain += gain;
+            statistics.total_time_us += time_us;
+            statistics.total_reward += static_cast<double>(gain) / std::max(time_us, 1.0);
+            m_neighborhood_calls++;
+        }
+
+        if (improved) {
+            active_neighborhoods = ALL_NEIGHBORHOODS;
         } else {
-            neighborhoods.erase(neighborhoods.begin() + static_cast<long>(current_neighborhood));
+            active_neighborhoods &= ~(1U << static_cast<uint32_t>(current_neighborhood));
         }
     }
+    if (active_neighborhoods == 0) {
+        m_visited_optima[solution.hash & (VISITED_OPTIMA_CAPACITY - 1)] = solution.hash;
+    }
+    assert(solution.test_hash());
     assert(solution.test_feasibility(m_instance));
 }
+
+std::array<double, ASP::NUM_NEIGHBORHOODS> ASP::neighborhood_weights() const {
+    std::array<double, NUM_NEIGHBORHOODS> weights{};
+    double total_weight = 0;
+
+    for (size_t i = 0; i < NUM_NEIGHBORHOODS; ++i) {
+        if (m_neighborhood_statistics[i].calls > 0) {
+            weights[i] =
+                m_neighborhood_statistics[i].total_reward / static_cast<double>(m_neighborhood_statistics[i].calls);
+            total_weight += weights[i];
+        }
+    }
+    if (total_weight > 0) {
+        for (double &weight : weights) {
+            weight /= total_weight;
+        }
+    }
+    return weights;
+}
+
+void ASP::print_neighborhood_weights() const {
+    constexpr std::array<const char *, NUM_NEIGHBORHOODS> names{"Intra swap", "Inter swap", "Intra move",
+                                                                "Inter move", "Time slot assignment"};
+    const std::array<double, NUM_NEIGHBORHOODS> weights = neighborhood_weights();
+
+    std::cout << "\nNeighborhood weights (calls, improvements, average time):\n";
+    for (size_t i = 0; i < NUM_NEIGHBORHOODS; ++i) {
+        const NeighborhoodStatistics &statistics = m_neighborhood_statistics[i];
+        const double average_time_us =
+            statistics.calls > 0 ? statistics.total_time_us / static_cast<double>(statistics.calls) : 0;
+
+        std::cout << '\t' << names[i] << ": " << weights[i] << " (" << statistics.calls << ", "
+                  << statistics.improvements << ", " << average_time_us << " us)\n";
+    }
+}
@@ -12,7 +12,7 @@ void ASP::VND(Solution &solution) { // NOLINT
 
     size_t current_neighborhood = 0;
 
-    while (current_neighborhood < neighborhoods.size()) {
+    while (current_neighborhood < neighborhoods.size() and not time_expired()) {
         bool improved = false;
 
         switch (neighborhoods[current_neighborhood]) {
@@ -28,6 +28,9 @@ void ASP::VND(Solution &solution) { // NOLINT
         case Neighborhood::InterMove:
             improved = best_improvement_inter_move(solution);
             break;
+        case Neighborhood::TimeSlotAssignment:
+            improved = best_improvement_time_slot_assignment(solution);
+            break;
         }
         if (improved) {
             current_neighborhood = 0;
@@ -35,5 +38,6 @@ void ASP::VND(Solution &solution) { // NOLINT
             ++current_neighborhood;
         }
     }
+    assert(solution.test_hash());
     assert(solution.test_feasibility(m_instance));
 }
@@ -0,0 +1,245 @@
+#include "ASP.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+constexpr std::array<char, 8> CHECKPOINT_MAGIC{'A', 'S', 'P', 'C', 'K', 'P', 'T', '1'};
+
+// Little-endian machines only, as the checkpoint is meant to be resumed where it was written
+template <typename T> void write_value(std::ofstream &file, const T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> T read_value(std::ifstream &file) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value{};
+    file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+}
+
+// Flight ids are written as 32 bits, which halves the file
+void write_sequences(std::ofstream &file, const std::vector<std::vector<size_t>> &sequences) {
+    write_value<uint32_t>(file, static_cast<uint32_t>(sequences.size()));
+
+    for (const std::vector<size_t> &sequence : sequences) {
+        write_value<uint32_t>(file, static_cast<uint32_t>(sequence.size()));
+
+        for (const size_t flight : sequence) {
+            write_value<uint32_t>(file, static_cast<uint32_t>(flight));
+        }
+    }
+}
+
+// The counts are checked before anything is allocated, a damaged file must not request a huge allocation
+uint32_t read_count(std::ifstream &file, const size_t max_count) {
+    const auto count = read_value<uint32_t>(file);
+
+    if (file.fail() or count > max_count) throw std::runtime_error("Invalid checkpoint file");
+    return count;
+}
+
+void read_sequences(std::ifstream &file, std::vector<std::vector<size_t>> &sequences, const size_t num_runways,
+                    const size_t num_flights) {
+    sequences.resize(read_count(file, num_runways));
+
+    for (std::vector<size_t> &sequence : sequences) {
+        sequence.resize(read_count(file, num_flights));
+
+        for (size_t &flight : sequence) {
+            flight = read_value<uint32_t>(file);
+
+            if (flight >= num_flights) throw std::runtime_error("Invalid checkpoint file");
+        }
+    }
+}
+
+} // namespace
+
+void ASP::checkpoint(const Solution &local_best, const Solution *incumbent, const size_t ils_iteration,
+                     const size_t revisits) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < m_next_checkpoint) return;
+
+    m_checkpoint.ils_iteration = ils_iteration;
+    m_checkpoint.revisits = revisits;
+    m_checkpoint.elapsed = std::chrono::duration<double>(now - m_start_time).count();
+
+    if (m_checkpoint_best != nullptr and not m_checkpoint_best->runways.empty()) {
+        m_checkpoint_best->get_sequences(m_checkpoint.best_found);
+    } else {
+        m_checkpoint.best_found.clear();
+    }
+    local_best.get_sequences(m_checkpoint.local_best);
+
+    if (incumbent != nullptr) {
+        incumbent->get_sequences(m_checkpoint.incumbent);
+    } else {
+        m_checkpoint.incumbent.clear();
+    }
+    m_checkpoint.late_acceptance = m_late_acceptance;
+    m_checkpoint.acceptance_iteration = m_acceptance_iteration;
+
+    write_checkpoint();
+
+    m_next_checkpoint = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(checkpoint_interval));
+}
+
+void ASP::write_checkpoint() {
+    std::filesystem::path temporary_file = checkpoint_file;
+    temporary_file += ".tmp";
+
+    {
+        std::ofstream file(temporary_file, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open checkpoint file");
+        }
+
+        file.write(CHECKPOINT_MAGIC.data(), CHECKPOINT_MAGIC.size());
+        write_value<uint64_t>(file, m_instance.get_num_flights());
+        write_value<uint64_t>(file, m_instance.get_num_runways());
+
+        // Progress
+        write_value<uint64_t>(file, m_checkpoint.iteration);
+        write_value<uint64_t>(file, m_checkpoint.ils_iteration);
+        write_value<uint64_t>(file, m_checkpoint.revisits);
+        write_value<double>(file, m_checkpoint.elapsed);
+        write_value<uint64_t>(file, m_best_objective);
+        write_value<double>(file, m_time_to_best);
+
+        for (const uint64_t word : m_generator.state()) {
+            write_value<uint64_t>(file, word);
+        }
+
+        // Solutions
+        write_sequences(file, m_checkpoint.best_found);
+        write_sequences(file, m_checkpoint.local_best);
+        write_sequences(file, m_checkpoint.incumbent);
+
+        write_value<uint64_t>(file, m_checkpoint.acceptance_iteration);
+        write_value<uint32_t>(file, static_cast<uint32_t>(m_checkpoint.late_acceptance.size()));
+        for (const size_t objective : m_checkpoint.late_acceptance) {
+            write_value<uint64_t>(file, objective);
+        }
+
+        write_value<uint32_t>(file, static_cast<uint32_t>(m_elite_pool.size()));
+        for (const EliteSolution &elite : m_elite_pool) {
+            write_value<uint64_t>(file, elite.objective);
+            write_sequences(file, elite.sequences);
+        }
+
+        // Statistics
+        write_value<uint64_t>(file, m_local_searches);
+        write_value<uint64_t>(file, m_revisits);
+        write_value<uint64_t>(file, m_improving_passes);
+        write_value<uint64_t>(file, m_applied_moves);
+        write_value<uint64_t>(file, m_accepted_worse);
+        write_value<uint64_t>(file, m_neighborhood_calls);
+
+        for (const NeighborhoodStatistics &statistics : m_neighborhood_statistics) {
+            write_value<NeighborhoodStatistics>(file, statistics);
+        }
+
+        // Visited local optima, only the used slots
+        const auto num_visited = static_cast<uint32_t>(std::count_if(
+            m_visited_optima.begin(), m_visited_optima.end(), [](const uint64_t hash) { return hash != 0; }));
+
+        write_value<uint32_t>(file, static_cast<uint32_t>(m_visited_optima.size()));
+        write_value<uint32_t>(file, num_visited);
+        for (const uint64_t hash : m_visited_optima) {
+            if (hash != 0) write_value<uint64_t>(file, hash);
+        }
+
+        if (!file.flush()) {
+            throw std::runtime_error("Failed to write checkpoint file");
+        }
+    }
+    std::filesystem::rename(temporary_file, checkpoint_file);
+}
+
+bool ASP::read_checkpoint() {
+    std::ifstream file(checkpoint_file, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::array<char, CHECKPOINT_MAGIC.size()> magic{};
+    file.read(magic.data(), magic.size());
+
+    if (magic != CHECKPOINT_MAGIC or read_value<uint64_t>(file) != m_instance.get_num_flights() or
+        read_value<uint64_t>(file) != m_instance.get_num_runways()) {
+        throw std::runtime_error("Checkpoint file does not match the instance");
+    }
+
+    m_checkpoint.iteration = read_value<uint64_t>(file);
+    m_checkpoint.ils_iteration = read_value<uint64_t>(file);
+    m_checkpoint.revisits = read_value<uint64_t>(file);
+    m_checkpoint.elapsed = read_value<double>(file);
+    m_best_objective = read_value<uint64_t>(file);
+    m_time_to_best = read_value<double>(file);
+
+    std::array<uint64_t, 4> state{};
+    for (uint64_t &word : state) {
+        word = read_value<uint64_t>(file);
+    }
+    m_generator.set_state(state);
+
+    const size_t num_flights = m_instance.get_num_flights();
+    const size_t num_runways = m_instance.get_num_runways();
+
+    read_sequences(file, m_checkpoint.best_found, num_runways, num_flights);
+    read_sequences(file, m_checkpoint.local_best, num_runways, num_flights);
+    read_sequences(file, m_checkpoint.incumbent, num_runways, num_flights);
+
+    m_checkpoint.acceptance_iteration = read_value<uint64_t>(file);
+    m_checkpoint.late_acceptance.resize(read_count(file, std::max<size_t>(1, late_acceptance_length)));
+    for (size_t &objective : m_checkpoint.late_acceptance) {
+        objective = read_value<uint64_t>(file);
+    }
+
+    m_elite_pool.resize(read_count(file, elite_size));
+    for (EliteSolution &elite : m_elite_pool) {
+        elite.objective = read_value<uint64_t>(file);
+        read_sequences(file, elite.sequences, num_runways, num_flights);
+        compute_predecessors(elite);
+    }
+
+    m_local_searches = read_value<uint64_t>(file);
+    m_revisits = read_value<uint64_t>(file);
+    m_improving_passes = read_value<uint64_t>(file);
+    m_applied_moves = read_value<uint64_t>(file);
+    m_accepted_worse = read_value<uint64_t>(file);
+    m_neighborhood_calls = read_value<uint64_t>(file);
+
+    for (NeighborhoodStatistics &statistics : m_neighborhood_statistics) {
+        statistics = read_value<NeighborhoodStatistics>(file);
+    }
+
+    // RVND indexes the table as VISITED_OPTIMA_CAPACITY slots, so no other size is valid
+    const auto visited_capacity = read_count(file, VISITED_OPTIMA_CAPACITY);
+    if (visited_capacity != 0 and visited_capacity != VISITED_OPTIMA_CAPACITY) {
+        throw std::runtime_error("Invalid checkpoint file");
+    }
+    m_visited_optima.assign(visited_capacity, 0);
+    const auto num_visited = read_count(file, visited_capacity);
+
+    for (uint32_t i = 0; i < num_visited and not m_visited_optima.empty(); ++i) {
+        const auto hash = read_value<uint64_t>(file);
+        m_visited_optima[hash & (m_visited_optima.size() - 1)] = hash;
+    }
+
+    if (file.fail() or m_checkpoint.local_best.size() != m_instance.get_num_runways()) {
+        throw std::runtime_error("Invalid checkpoint file");
+    }
+    return true;
+}
@@ -4,22 +4,154 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
 
+namespace {
+
+// Insertion of a candidate flight at the end of a runway
 struct Insertion {
-    size_t candidate_i;
+    size_t flight;
     uint32_t start_time;
     uint32_t penalty;
     uint32_t runway;
 
-    Insertion(size_t candidate_i, uint32_t start_time, uint32_t penalty, uint32_t runway)
-        : candidate_i(candidate_i), start_time(start_time), penalty(penalty), runway(runway) {}
+    Insertion(size_t flight, uint32_t start_time, uint32_t penalty, uint32_t runway)
+        : flight(flight), start_time(start_time), penalty(penalty), runway(runway) {}
+
+    // By penalty, ties by flight then runway so that the candidate list does not depend on the order of the entries
+    bool operator<(const Insertion &other) const {
+        if (penalty != other.penalty) return penalty < other.penalty;
+        if (flight != other.flight) return flight < other.flight;
+        return runway < other.runway;
+    }
+};
+
+// Runways ordered by the time their last flight frees them (start time + runway occupancy), in a binary min-heap.
+// The start time of a flight on a runway also depends on the separation from its last flight, so the lowest start
+// time is found by walking the heap and skipping the subtrees that free their runways after the best start so far.
+class RunwayFrontier {
+private:
+    std::vector<size_t> m_heap;          // Runways, by (free time, runway)
+    std::vector<size_t> m_heap_position; // Position of each runway in m_heap
+    std::vector<uint32_t> m_free_times;
+    std::vector<size_t> m_stack;
+
+    bool less(const size_t runway_a, const size_t runway_b) const {
+        return m_free_times[runway_a] < m_free_times[runway_b] or
+               (m_free_times[runway_a] == m_free_times[runway_b] and runway_a < runway_b);
+    }
+
+public:
+    // Every runway of solution must have a flight
+    explicit RunwayFrontier(const Solution &solution)
+        : m_heap(solution.runways.size()), m_heap_position(solution.runways.size()),
+          m_free_times(solution.runways.size()) {
+        m_stack.reserve(solution.runways.size());
+
+        for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+            const Flight &last_flight = solution.runways[runway_i].sequence.back().get();
+            m_free_times[runway_i] = last_flight.start_time + last_flight.get_runway_occupancy_time();
+            m_heap[runway_i] = runway_i;
+        }
+        std::sort(m_heap.begin(), m_heap.end(), [&](const size_t a, const size_t b) { return less(a, b); });
+
+        for (size_t position = 0; position < m_heap.size(); ++position) {
+            m_heap_position[m_heap[position]] = position;
+        }
+    }
+
+    // Runway where flight starts first (the lowest one on ties) and its start time
+    std::pair<size_t, uint32_t> earliest_start(const Instance &instance, const Solution &solution,
+                                               const Flight &flight) {
+        size_t best_runway = solution.runways.size();
+        uint32_t best_start_time = std::numeric_limits<uint32_t>::max();
+
+        m_stack.push_back(0);
+        while (not m_stack.empty()) {
+            const size_t position = m_stack.back();
+            m_stack.pop_back();
+
+            const size_t runway_i = m_heap[position];
+            if (m_free_times[runway_i] > best_start_time) continue; // Neither can its subtree
+
+            const Flight &last_flight = solution.runways[runway_i].sequence.back().get();
+            const uint32_t start_time =
+                std::max(flight.get_release_time(),
+                         m_free_times[runway_i] + instance.get_separation_time(last_flight.get_id(), flight.get_id()));
+
+            if (start_time < best_start_time or (start_time == best_start_time and runway_i < best_runway)) {
+                best_start_time = start_time;
+                best_runway = runway_i;
+            }
+            for (size_t child = (2 * position) + 1; child <= (2 * position) + 2 and child < m_heap.size(); ++child) {
+                m_stack.push_back(child);
+            }
+        }
+        return {best_runway, best_start_time};
+    }
+
+    // New last flight of runway_i, which can only free it later
+    void update(const size_t runway_i, const Flight &last_flight) {
+        m_free_times[runway_i] = last_flight.start_time + last_flight.get_runway_occupancy_time();
+
+        size_t position = m_heap_position[runway_i];
+        while (true) {
+            size_t smallest = position;
+
+            for (size_t child = (2 * position) + 1; child <= (2 * position) + 2 and child < m_heap.size(); ++child) {
+                if (less(m_heap[child], m_heap[smallest])) smallest = child;
+            }
+            if (smallest == position) break;
+
+            std::swap(m_heap[position], m_heap[smallest]);
+            m_heap_position[m_heap[position]] = position;
+            position = smallest;
+        }
+        m_heap[position] = runway_i;
+        m_heap_position[runway_i] = position;
+    }
 };
 
+// Roulette wheel over the runways with a probability proportional to the inverse of the start time, rounded down
+// to whole percents. cumulative is scratch space, so that no allocation happens per flight.
+size_t choose_runway(const std::vector<uint32_t> &start_times, std::vector<uint32_t> &cumulative,
+                     Xoshiro256 &generator) {
+    float sum = 0;
+    for (const uint32_t start_time : start_times) {
+        sum += 1.0F / static_cast<float>(std::max<uint32_t>(1, start_time)); // A start time of 0 weighs as 1
+    }
+
+    uint32_t total = 0;
+    size_t best_runway = 0;
+    for (size_t runway_i = 0; runway_i < start_times.size(); ++runway_i) {
+        const float value = 1.0F / static_cast<float>(std::max<uint32_t>(1, start_times[runway_i]));
+
+        total += static_cast<uint32_t>(std::floor((value / sum) * 100));
+        cumulative[runway_i] = total;
+
+        if (start_times[runway_i] < start_times[best_runway]) best_runway = runway_i;
+    }
+
+    // Every runway rounded down to 0% (more than 100 runways): the one where the flight starts first
+    if (total == 0) return best_runway;
+
+    const size_t number = std::uniform_int_distribution<size_t>(1, total)(generator);
+
+    return static_cast<size_t>(std::lower_bound(cumulative.begin(), cumulative.end(), number) - cumulative.begin());
+}
+
+} // namespace
+
 Solution ASP::randomized_greedy(const double alpha, std::vector<Flight> &flights) {
+    OperatorScope scope(*this, Operator::RandomizedGreedy);
     Solution solution(m_instance);
 
     std::vector<std::reference_wrapper<Flight>> candidate_list;
@@ -28,7 +160,6 @@ Solution ASP::randomized_greedy(const double alpha, std::vector<Flight> &flights
     for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
         candidate_list.emplace_back(flights[i]);
     }
-    std::vector<size_t> candidates_position(m_instance.get_num_flights());
 
     std::sort(candidate_list.begin(), candidate_list.end(), [](const auto flight_a, const auto flight_b) {
         return flight_a.get().get_release_time() > flight_b.get().get_release_time();
@@ -47,59 +178,74 @@ Solution ASP::randomized_greedy(const double alpha, std::vector<Flight> &flights
         candidate_list.pop_back();
     }
 
-    while (not candidate_list.empty()) {
-        std::vector<Insertion> possible_insertions;
-
-        possible_insertions.reserve(m_instance.get_num_runways() * candidate_list.size());
-
-        for (int candidate_i = static_cast<int>(candidate_list.size()) - 1; candidate_i >= 0; --candidate_i) {
-            Flight &candidate = candidate_list[candidate_i];
-
-            candidates_position[candidate.get_id()] = candidate_i;
-
-            for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
-                auto last_flight = solution.runways[runway_i].sequence.back();
-
-                uint32_t earliest = last_flight.get().start_time + last_flight.get().get_runway_occupancy_time() +
-                                    m_instance.get_separation_time(last_flight.get().get_id(), candidate.get_id());
+    // Insertion of each remaining flight at the end of each runway. Only the insertions on the runway that received
+    // the last flight change, so they are the only ones recomputed.
+    const auto insertion = [&](const Flight &candidate, const size_t runway_i) {
+        const Flight &last_flight = solution.runways[runway_i].sequence.back().get();
 
-                uint32_t start_time = std::max(earliest, candidate.get_release_time());
+        const uint32_t earliest = last_flight.start_time + last_flight.get_runway_occupancy_time() +
+                                  m_instance.get_separation_time(last_flight.get_id(), candidate.get_id());
+        const uint32_t start_time = std::max(earliest, candidate.get_release_time());
+        const uint32_t penalty = (start_time - candidate.get_release_time()) * candidate.get_delay_penalty();
 
-                uint32_t delay = start_time - candidate.get_release_time();
+        return Insertion(candidate.get_id(), start_time, penalty, static_cast<uint32_t>(runway_i));
+    };
 
-                size_t insertion_penalty = candidate.get_delay_penalty() * delay;
+    std::vector<Insertion> possible_insertions;
+    possible_insertions.reserve(m_instance.get_num_runways() * candidate_list.size());
 
-                possible_insertions.emplace_back(candidate_i, start_time, insertion_penalty, runway_i);
-            }
+    for (const Flight &candidate : candidate_list) {
+        for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+            possible_insertions.push_back(insertion(candidate, runway_i));
         }
-        std::sort(possible_insertions.begin(), possible_insertions.end(),
-                  [](const Insertion &a, const Insertion &b) { return a.penalty < b.penalty; });
+    }
+
+    while (not possible_insertions.empty()) {
+        // Restricted candidate list: the ceil(alpha * size) + 1 cheapest insertions, only the drawn one is selected
+        const auto rcl_size = static_cast<size_t>(std::ceil(alpha * static_cast<double>(possible_insertions.size())));
+        std::uniform_int_distribution<size_t> dist_selection(0, std::min(rcl_size, possible_insertions.size() - 1));
 
-        std::uniform_int_distribution<size_t> dist_selection(
-            0, std::ceil(alpha * static_cast<float>(possible_insertions.size())));
+        const auto selected_i = static_cast<std::ptrdiff_t>(dist_selection(m_generator));
+        std::nth_element(possible_insertions.begin(), possible_insertions.begin() + selected_i,
+                         possible_insertions.end());
 
-        Insertion selected_insertion = possible_insertions[dist_selection(m_generator)];
-        Flight &selected_candidate = candidate_list[selected_insertion.candidate_i].get();
+        const Insertion selected_insertion = possible_insertions[static_cast<size_t>(selected_i)];
+        Flight &selected_candidate = flights[selected_insertion.flight];
+        Runway &runway = solution.runways[selected_insertion.runway];
 
         selected_candidate.start_time = selected_insertion.start_time;
         selected_candidate.runway = selected_insertion.runway;
-        selected_candidate.position = solution.runways[selected_insertion.runway].sequence.size();
+        selected_candidate.position = runway.sequence.size();
 
-        solution.runways[selected_insertion.runway].sequence.emplace_back(selected_candidate);
-        solution.runways[selected_insertion.runway].penalty += selected_insertion.penalty;
-        solution.runways[selected_insertion.runway].prefix_penalty.push_back(
-            solution.runways[selected_insertion.runway].penalty);
+        runway.sequence.emplace_back(selected_candidate);
+        runway.penalty += selected_insertion.penalty;
+        runway.prefix_penalty.push_back(runway.penalty);
         solution.objective += selected_insertion.penalty;
 
-        candidate_list.erase(candidate_list.begin() + static_cast<long>(selected_insertion.candidate_i));
+        // Drop the insertions of the selected flight (swap and pop) and update the ones on its runway
+        for (size_t i = 0; i < possible_insertions.size();) {
+            Insertion &entry = possible_insertions[i];
+
+            if (entry.flight == selected_insertion.flight) {
+                entry = possible_insertions.back();
+                possible_insertions.pop_back();
+                continue;
+            }
+            if (entry.runway == selected_insertion.runway) {
+                entry = insertion(flights[entry.flight], entry.runway);
+            }
+            ++i;
+        }
     }
 
+    solution.update_hash();
     assert(solution.test_feasibility(m_instance));
 
     return solution;
 }
 
 Solution ASP::lowest_release_time_insertion(std::vector<Flight> &flights) {
+    OperatorScope scope(*this, Operator::LowestReleaseTimeInsertion);
     Solution solution(m_instance);
 
     // Initialization of the candidate list
@@ -109,10 +255,9 @@ Solution ASP::lowest_release_time_insertion(std::vector<Flight> &flights) {
     for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
         candidate_list.emplace_back(flights[i]);
     }
-    std::vector<size_t> candidates_position(m_instance.get_num_flights());
 
     // Ordering 
-    int i = std::rand() % 10;
+    size_t i = random_index(10);
 
     if (i < 6) {
         std::sort(candidate_list.begin(), candidate_list.end(), [](const auto flight_a, const auto flight_b) {
@@ -125,7 +270,7 @@ Solution ASP::lowest_release_time_insertion(std::vector<Flight> &flights) {
     }
 
     for (size_t i = candidate_list.size() - 1; i >= candidate_list.size() - m_instance.get_num_runways(); i--) {
-        int prob_swap = std::rand() % 10;
+        size_t prob_swap = random_index(10);
         if (prob_swap < 3) std::swap(candidate_list[i], candidate_list[i - m_instance.get_num_runways()]);
     }
 
@@ -145,100 +290,39 @@ Solution ASP::lowest_release_time_insertion(std::vector<Flight> &flights) {
         candidate_list.pop_back();
     }
 
-    // Insert all the flights in the solution
-    size_t best_runway;
-    size_t lowest_start_time;
-    size_t start_time;
-    while (!candidate_list.empty()) {
-
-        // Search the best runway which the start time be the lowest possible
-        best_runway = 0;
-        lowest_start_time = std::numeric_limits<size_t>::max();
-
-        const Flight &current_flight = candidate_list.back().get(); // the flight who will be insert
-
-        for (size_t runway_i = 0; runway_i < m_instance.get_num_runways(); ++runway_i) {
-            const Flight &prev_flight =
-                solution.runways[runway_i].sequence.back().get(); // the actual last flight in the runway
-
-            const uint32_t earliest = prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
-                                      m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id());
+    // Insert all the flights in the solution, each one on the runway where it starts first
+    RunwayFrontier frontier(solution);
 
-            start_time = std::max(earliest, current_flight.get_release_time());
-
-            if (start_time < lowest_start_time) {
-                lowest_start_time = start_time;
-                best_runway = runway_i;
-            }
-        }
+    while (!candidate_list.empty()) {
+        Flight &candidate = candidate_list.back().get(); // the flight who will be insert
 
-        uint32_t current_flight_penalty =
-            (lowest_start_time - current_flight.get_release_time()) * current_flight.get_delay_penalty();
-        solution.runways[best_runway].prefix_penalty.push_back(
-            solution.runways[best_runway]
-                .prefix_penalty[solution.runways[best_runway].sequence.size()] // the prefix of the last flight in the
-                                                                               // runwawy
-            + current_flight_penalty); // O prefix penalty dele é o prefix penalty do anterior mais o penalty dele
-        solution.runways[best_runway].sequence.emplace_back(candidate_list.back()); // Coloca ele no final daquela pista
+        const auto [best_runway, lowest_start_time] = frontier.earliest_start(m_instance, solution, candidate);
+        Runway &best = solution.runways[best_runway];
 
-        Flight &candidate = candidate_list.back().get(); // Facilitar a escrita
+        const uint32_t current_flight_penalty =
+            (lowest_start_time - candidate.get_release_time()) * candidate.get_delay_penalty();
 
-        // Atualiza seus valores
-        candidate.position = solution.runways[best_runway].sequence.size() - 1;
+        candidate.position = best.sequence.size();
         candidate.runway = best_runway;
         candidate.start_time = lowest_start_time;
 
-        solution.runways[best_runway].penalty += current_flight_penalty;
+        best.sequence.emplace_back(candidate);
+        best.penalty += current_flight_penalty;
+        best.prefix_penalty.push_back(best.penalty); // Prefix penalty of the last flight plus its own
         solution.objective += current_flight_penalty;
 
-        // Apaga ele da lista de candidatos
+        frontier.update(best_runway, candidate);
         candidate_list.pop_back();
     }
 
+    solution.update_hash();
     assert(solution.test_feasibility(m_instance));
 
     return solution;
 }
 
-size_t choose_runway(std::vector<size_t> start_time) {
-    std::vector<float> values;
-    float soma = 0;
-
-    // std::cout << "\nIniciando escolha:\n";
-
-    // inverte os valores
-    for (size_t i = 0; i < start_time.size(); i++) {
-        values.push_back((float)1 / start_time[i]);
-        soma += values[i];
-        // std::cout << "Start time: " << start_time[i] << std::endl;
-    }
-
-    // calcula as probabilidades
-    for (size_t i = 0; i < values.size(); i++) {
-        values[i] = floor((values[i] / soma) * 100);
-        // std::cout << "Probabilidade: " << values[i] << std::endl;
-    }
-
-    // calcula os intervalos
-    soma = 0;
-    for (size_t i = 0; i < values.size(); i++) {
-        values[i] = soma + values[i];
-        soma = values[i];
-        // std::cout << "Intervalo: " << values[i] << std::endl;
-    }
-
-    // escolho um numero
-    size_t numero = rand() % (int)soma + 1;
-
-    for (size_t i = 0; i < values.size(); i++) {
-        if (numero <= values[i]) {
-            // std::cout << "Choosed: " << i << std::endl;
-            return i;
-        }
-    }
-}
-
 Solution ASP::rand_lowest_release_time_insertion(std::vector<Flight> &flights) {
+    OperatorScope scope(*this, Operator::RandLowestReleaseTimeInsertion);
     Solution solution(m_instance);
 
     // Initialization of the candidate list
@@ -248,66 +332,88 @@ Solution ASP::rand_lowest_release_time_insertion(std::vector<Flight> &flights) {
     for (size_t i = 0; i < m_instance.get_num_flights(); ++i) {
         candidate_list.emplace_back(flights[i]);
     }
-    std::vector<size_t> candidates_position(m_instance.get_num_flights());
-
     // Ordering of the candidate list by release time
     std::sort(candidate_list.begin(), candidate_list.end(), [](const auto flight_a, const auto flight_b) {
         return flight_a.get().get_release_time() > flight_b.get().get_release_time();
     });
 
-    // Insert all the flights in the solution
-    size_t choosed_runway;
-    std::vector<size_t> start_time(m_instance.get_num_runways());
+    // Insert all the flights in the solution, each one on a runway drawn by its start time there
+    std::vector<uint32_t> start_times(m_instance.get_num_runways());
+    std::vector<uint32_t> cumulative(m_instance.get_num_runways());
+    size_t empty_runways = m_instance.get_num_runways();
 
     while (!candidate_list.empty()) {
-
-        const Flight &current_flight = candidate_list.back().get(); // the flight who will be insert
+        Flight &candidate = candidate_list.back().get(); // the flight who will be insert
 
         for (size_t runway_i = 0; runway_i < m_instance.get_num_runways(); ++runway_i) {
-            if(solution.runways[runway_i].sequence.size() == 0){ //if the runway is empty
-                start_time[runway_i] = current_flight.get_release_time();
-            }else{
-                const Flight &prev_flight =
-                    solution.runways[runway_i].sequence.back().get(); // the actual last flight in the runway
+            const Runway &runway = solution.runways[runway_i];
 
-                const uint32_t earliest = prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
-                    m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id());
+            if (runway.sequence.empty()) {
+                start_times[runway_i] = candidate.get_release_time();
+            } else {
+                const Flight &prev_flight = runway.sequence.back().get(); // the actual last flight in the runway
 
-                start_time[runway_i] = std::max(earliest, current_flight.get_release_time());
-            }
+                const uint32_t earliest = prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
+                                          m_instance.get_separation_time(prev_flight.get_id(), candidate.get_id());
 
-            if(start_time[runway_i] == 0){ //nem sei se realmente cairia nesse caso, mas vai que
-                start_time[runway_i]++; // can't be 0 because I will invert in the function choose_runway
+                start_times[runway_i] = std::max(earliest, candidate.get_release_time());
             }
         }
 
-        choosed_runway = choose_runway(start_time);
-
-        uint32_t current_flight_penalty =
-            (start_time[choosed_runway] - current_flight.get_release_time()) * current_flight.get_delay_penalty();
-        solution.runways[choosed_runway].prefix_penalty.push_back(
-            solution.runways[choosed_runway]
-                .prefix_penalty[solution.runways[choosed_runway].sequence.size()] // the prefix of the last flight in
-                                                                                  // the runwawy
-            + current_flight_penalty); // O prefix penalty dele é o prefix penalty do anterior mais o penalty dele
-        solution.runways[choosed_runway].sequence.emplace_back(
-            candidate_list.back()); // Coloca ele no final daquela pista
+        // The neighborhoods never empty a runway nor expect one empty, so the last flights fill the empty ones
+        size_t chosen_runway;
+        if (candidate_list.size() == empty_runways) {
+            chosen_runway = 0;
+            while (not solution.runways[chosen_runway].sequence.empty()) ++chosen_runway;
+        } else {
+            chosen_runway = choose_runway(start_times, cumulative, m_generator);
+        }
+        Runway &runway = solution.runways[chosen_runway];
+        if (runway.sequence.empty()) --empty_runways;
 
-        Flight &candidate = candidate_list.back().get(); // Facilitar a escrita
+        const uint32_t current_flight_penalty =
+            (start_times[chosen_runway] - candidate.get_release_time()) * candidate.get_delay_penalty();
 
-        // Atualiza seus valores
-        candidate.position = solution.runways[choosed_runway].sequence.size() - 1;
-        candidate.runway = choosed_runway;
-        candidate.start_time = start_time[choosed_runway];
+        candidate.position = runway.sequence.size();
+        candidate.runway = chosen_runway;
+        candidate.start_time = start_times[chosen_runway];
 
-        solution.runways[choosed_runway].penalty += current_flight_penalty;
+        runway.sequence.emplace_back(candidate);
+        runway.penalty += current_flight_penalty;
+        runway.prefix_penalty.push_back(runway.penalty); // Prefix penalty of the last flight plus its own
         solution.objective += current_flight_penalty;
 
-        // Apaga ele da lista de candidatos
         candidate_list.pop_back();
     }
 
+    solution.update_hash();
     assert(solution.test_feasibility(m_instance));
 
     return solution;
 }
+
+Solution ASP::regret_insertion(const size_t regret_k, std::vector<Flight> &flights) {
+    OperatorScope scope(*this, Operator::RegretInsertion);
+    Solution solution(m_instance);
+
+    // Every flight is removed, ties of regret and cost go to the earliest release time
+    m_removed_flights.assign(flights.begin(), flights.end());
+    std::stable_sort(m_removed_flights.begin(), m_removed_flights.end(), [](const auto flight_a, const auto flight_b) {
+        return flight_a.get().get_release_time() < flight_b.get().get_release_time();
+    });
+
+    insert_removed_flights(solution, regret_k);
+
+    return solution;
+}
+
+Solution ASP::construct(std::vector<Flight> &flights) {
+    switch (construction) {
+    case Construction::LowestReleaseTime:
+        return lowest_release_time_insertion(flights);
+    case Construction::Regret:
+        return regret_insertion(regret_k, flights);
+    default:
+        return rand_lowest_release_time_insertion(flights);
+    }
+}
@@ -0,0 +1,74 @@
+#include "hungarian.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+uint64_t Hungarian::solve(const std::vector<uint32_t> &cost, const size_t n, std::vector<size_t> &assignment) {
+    constexpr int64_t INF = std::numeric_limits<int64_t>::max();
+
+    // Potentials and matching use 1-based indices, index 0 is the virtual column of the current row
+    m_u.assign(n + 1, 0);
+    m_v.assign(n + 1, 0);
+    m_p.assign(n + 1, 0);
+    m_way.assign(n + 1, 0);
+
+    for (size_t row = 1; row <= n; ++row) {
+        m_p[0] = row;
+        size_t column_0 = 0;
+
+        m_min_v.assign(n + 1, INF);
+        m_used.assign(n + 1, false);
+
+        // Grow an alternating tree from row until a free column is reached
+        do {
+            m_used[column_0] = true;
+
+            const size_t row_0 = m_p[column_0];
+            int64_t delta = INF;
+            size_t column_1 = 0;
+
+            for (size_t column = 1; column <= n; ++column) {
+                if (m_used[column]) continue;
+
+                const int64_t reduced_cost =
+                    static_cast<int64_t>(cost[((row_0 - 1) * n) + column - 1]) - m_u[row_0] - m_v[column];
+
+                if (reduced_cost < m_min_v[column]) {
+                    m_min_v[column] = reduced_cost;
+                    m_way[column] = column_0;
+                }
+                if (m_min_v[column] < delta) {
+                    delta = m_min_v[column];
+                    column_1 = column;
+                }
+            }
+
+            for (size_t column = 0; column <= n; ++column) {
+                if (m_used[column]) {
+                    m_u[m_p[column]] += delta;
+                    m_v[column] -= delta;
+                } else {
+                    m_min_v[column] -= delta;
+                }
+            }
+            column_0 = column_1;
+        } while (m_p[column_0] != 0);
+
+        // Augment along the path found
+        do {
+            const size_t column_1 = m_way[column_0];
+            m_p[column_0] = m_p[column_1];
+            column_0 = column_1;
+        } while (column_0 != 0);
+    }
+
+    assignment.resize(n);
+
+    uint64_t total_cost = 0;
+    for (size_t column = 1; column <= n; ++column) {
+        assignment[m_p[column] - 1] = column - 1;
+        total_cost += cost[((m_p[column] - 1) * n) + column - 1];
+    }
+    return total_cost;
+}
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <utility>
 
 Instance::Instance(std::filesystem::path &instance_file_path) : m_num_flights(0), m_num_runways(0) {
     std::ifstream file(instance_file_path);
@@ -39,6 +40,41 @@ Instance::Instance(std::filesystem::path &instance_file_path) : m_num_flights(0)
     }
 }
 
+Instance::Instance(const size_t num_runways, std::vector<uint32_t> release_times,
+                   std::vector<uint32_t> runway_occupancy_times, std::vector<uint32_t> delay_penalties,
+                   std::vector<uint32_t> separation_time_matrix)
+    : m_num_flights(release_times.size()), m_num_runways(num_runways), m_release_times(std::move(release_times)),
+      m_runway_occupancy_times(std::move(runway_occupancy_times)), m_delay_penalties(std::move(delay_penalties)),
+      m_separation_time_matrix(std::move(separation_time_matrix)) {}
+
+Instance Instance::window(const std::vector<size_t> &flights, const std::vector<uint32_t> &anchor_start_times,
+                          const uint32_t anchor_penalty) const {
+    const size_t num_window_flights = flights.size();
+    const size_t first_anchor = num_window_flights - anchor_start_times.size();
+
+    std::vector<uint32_t> release_times(num_window_flights);
+    std::vector<uint32_t> runway_occupancy_times(num_window_flights);
+    std::vector<uint32_t> delay_penalties(num_window_flights);
+    std::vector<uint32_t> separation_times(num_window_flights * num_window_flights);
+
+    for (size_t i = 0; i < num_window_flights; ++i) {
+        const bool anchor = i >= first_anchor;
+
+        release_times[i] = anchor ? anchor_start_times[i - first_anchor] : m_release_times[flights[i]];
+        runway_occupancy_times[i] = m_runway_occupancy_times[flights[i]];
+        delay_penalties[i] = anchor ? anchor_penalty : m_delay_penalties[flights[i]];
+    }
+    for (size_t i = 0; i < num_window_flights; ++i) {
+        for (size_t j = 0; j < num_window_flights; ++j) {
+            // An anchor starts later than its release time after any flight
+            separation_times[(i * num_window_flights) + j] =
+                j < first_anchor ? get_separation_time(flights[i], flights[j]) : release_times[j] + 1;
+        }
+    }
+    return {m_num_runways, std::move(release_times), std::move(runway_occupancy_times), std::move(delay_penalties),
+            std::move(separation_times)};
+}
+
 void Instance::print() const {
     std::cout << "Instance Data:\n";
     std::cout << "Number of flights: " << m_num_flights << "\n";
@@ -0,0 +1,87 @@
+#include "ASP.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Named after the functions, in the order of ASP::Operator
+constexpr std::array<const char *, ASP::NUM_OPERATORS> OPERATOR_NAMES{
+    "best_improvement_intra_swap",
+    "best_improvement_inter_swap",
+    "best_improvement_intra_move",
+    "best_improvement_inter_move",
+    "best_improvement_time_slot_assignment",
+    "first_improvement_intra_swap",
+    "first_improvement_inter_swap",
+    "first_improvement_intra_move",
+    "first_improvement_inter_move",
+    "move_worst_flight",
+    "intra_swap",
+    "inter_swap",
+    "inter_move",
+    "chain",
+    "random_inter_block_swap",
+    "randomized_greedy",
+    "lowest_release_time_insertion",
+    "rand_lowest_release_time_insertion",
+    "regret_insertion",
+};
+static_assert(OPERATOR_NAMES.back() != nullptr, "Every operator needs a name");
+
+// The RVND neighborhoods are reported under the names of their best improvement operators
+static_assert(static_cast<size_t>(ASP::Operator::BestImprovementTimeSlotAssignment) ==
+              static_cast<size_t>(ASP::Neighborhood::TimeSlotAssignment));
+
+} // namespace
+
+ASP::OperatorScope::OperatorScope(ASP &asp, const Operator op, const Solution *solution)
+    : statistics(asp.m_operator_statistics[static_cast<size_t>(op)]), m_solution(solution),
+      m_original_objective(solution != nullptr ? solution->objective : 0), m_start(std::chrono::steady_clock::now()) {}
+
+ASP::OperatorScope::~OperatorScope() {
+    statistics.calls++;
+    statistics.total_time_us +=
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count();
+
+    if (m_solution != nullptr) {
+        const int64_t gain = static_cast<int64_t>(m_original_objective) - static_cast<int64_t>(m_solution->objective);
+
+        statistics.total_gain += gain;
+        statistics.improvements += gain > 0 ? 1 : 0;
+    }
+}
+
+void ASP::OperatorScope::count_moves(const std::vector<Move> &moves) {
+    for (const Move &move : moves) {
+        statistics.evaluated += move.counters.evaluated;
+        statistics.pruned += move.counters.pruned;
+        statistics.shortcuts += move.counters.shortcuts;
+    }
+}
+
+void ASP::add_operator_statistics(const std::array<OperatorStatistics, NUM_OPERATORS> &operator_statistics) {
+    for (size_t i = 0; i < NUM_OPERATORS; ++i) {
+        const OperatorStatistics &worker_statistics = operator_statistics[i];
+        OperatorStatistics &statistics = m_operator_statistics[i];
+
+        statistics.calls += worker_statistics.calls;
+        statistics.evaluated += worker_statistics.evaluated;
+        statistics.pruned += worker_statistics.pruned;
+        statistics.shortcuts += worker_statistics.shortcuts;
+        statistics.improvements += worker_statistics.improvements;
+        statistics.total_gain += worker_statistics.total_gain;
+        statistics.total_time_us += worker_statistics.total_time_us;
+    }
+}
+
+const char *ASP::operator_name(const Operator op) { return OPERATOR_NAMES[static_cast<size_t>(op)]; }
+
+const char *ASP::operator_kind(const Operator op) {
+    if (op <= Operator::MoveWorstFlight) return "neighborhood";
+    if (op <= Operator::RandomInterBlockSwap) return "perturbation";
+    return "construction";
+}
@@ -0,0 +1,139 @@
+#include "ASP.hpp"
+#include "mailbox.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <omp.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t MAILBOX_CAPACITY = 4; // Migrants waiting for an island, newer ones are dropped when full
+
+// Solution travelling between islands, as flight ids since every island owns its flights
+struct Migrant {
+    size_t objective = std::numeric_limits<size_t>::max();
+    std::vector<std::vector<size_t>> sequences;
+};
+
+} // namespace
+
+Solution ASP::island_GILS_RVND(const size_t max_iterations, const size_t max_ils_iterations, // NOLINT
+                               const size_t migration_interval) {
+    const auto num_islands = static_cast<size_t>(omp_get_max_threads());
+
+    std::cout << ">> Island GILS-RVND (" << num_islands << " islands, migration every " << migration_interval
+              << " ILS iterations)\n";
+
+    start_clock();
+
+    std::vector<uint64_t> seeds(num_islands);
+    for (uint64_t &seed : seeds) {
+        seed = m_generator();
+    }
+
+    // Ring topology: island i sends to mailboxes[i + 1] and receives from mailboxes[i]
+    std::vector<Mailbox<Migrant, MAILBOX_CAPACITY>> mailboxes(num_islands);
+
+    // Filled by each island at the end, so no merge is needed while the islands run
+    std::vector<Migrant> island_bests(num_islands);
+    std::vector<size_t> island_best_objectives(num_islands, std::numeric_limits<size_t>::max());
+    std::vector<double> island_times_to_best(num_islands, 0);
+    std::vector<size_t> island_adoptions(num_islands, 0);
+
+#pragma omp parallel num_threads(static_cast<int>(num_islands))
+    {
+        const auto island = static_cast<size_t>(omp_get_thread_num());
+
+        // Each island owns its flights, scratch buffers and generator, only the instance is shared
+        ASP worker = *this;
+        worker.m_generator.seed(seeds[island]);
+
+#pragma omp barrier
+
+        Mailbox<Migrant, MAILBOX_CAPACITY> &inbox = mailboxes[island];
+        Mailbox<Migrant, MAILBOX_CAPACITY> &outbox = mailboxes[(island + 1) % num_islands];
+
+        Migrant &island_best = island_bests[island];
+        Migrant migrant;
+
+        // Every island runs its own GILS-RVND for the whole budget, so they all keep reading their mailboxes
+        for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+            if (worker.time_expired() and island_best.objective != std::numeric_limits<size_t>::max()) break;
+
+            Solution local_best = worker.construct(worker.flights);
+
+            worker.RVND(local_best);
+            worker.update_time_to_best(local_best.objective);
+
+            // The ILS runs migration_interval iterations at a time, the migrations take place in between
+            size_t ils_iteration = 1;
+
+            while (ils_iteration <= max_ils_iterations and not worker.time_expired()) {
+                ils_iteration = worker.ILS_RVND(local_best, max_ils_iterations, migration_interval, ils_iteration);
+
+                // Migration: send the island's best to the next island, adopt better incoming solutions
+                if (local_best.objective < island_best.objective) {
+                    local_best.get_sequences(island_best.sequences);
+                    island_best.objective = local_best.objective;
+                }
+                outbox.push(island_best);
+
+                while (inbox.pop(migrant)) {
+                    if (migrant.objective < local_best.objective) {
+                        worker.load_solution(local_best, migrant.sequences, worker.flights);
+                        island_adoptions[island]++;
+                        ils_iteration = 1;
+                    }
+                }
+            }
+
+            if (not worker.m_elite_pool.empty() and not worker.time_expired()) {
+                const EliteSolution &guide = worker.m_elite_pool[worker.random_index(worker.m_elite_pool.size())];
+
+                if (worker.path_relinking(local_best, guide)) worker.update_time_to_best(local_best.objective);
+            }
+            worker.add_to_elite_pool(local_best);
+
+            if (local_best.objective < island_best.objective) {
+                local_best.get_sequences(island_best.sequences);
+                island_best.objective = local_best.objective;
+            }
+        }
+
+        island_best_objectives[island] = worker.m_best_objective;
+        island_times_to_best[island] = worker.m_time_to_best;
+
+#pragma omp critical(island_statistics)
+        merge_statistics(worker);
+    }
+
+    size_t best_island = 0;
+    for (size_t island = 1; island < num_islands; ++island) {
+        if (island_bests[island].objective < island_bests[best_island].objective) {
+            best_island = island;
+        }
+    }
+
+    Solution best_found;
+    load_solution(best_found, island_bests[best_island].sequences, flights);
+
+    // Time to best of the island that found the best objective first (the others may have adopted it)
+    m_best_objective = best_found.objective;
+    m_time_to_best = std::numeric_limits<double>::max();
+    size_t adoptions = 0;
+
+    for (size_t island = 0; island < num_islands; ++island) {
+        if (island_best_objectives[island] == best_found.objective) {
+            m_time_to_best = std::min(m_time_to_best, island_times_to_best[island]);
+        }
+        adoptions += island_adoptions[island];
+    }
+
+    std::cout << "\nMigrants adopted: " << adoptions << '\n';
+    std::cout << "Best found: " << best_found.objective << " (island " << best_island << ")\n";
+    return best_found;
+}
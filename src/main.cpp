@@ -1,33 +1,224 @@
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <argparse/argparse.hpp>
 
 #include "ASP.hpp"
 #include "instance.hpp"
+#include "online.hpp"
 #include "solution.hpp"
 
+namespace {
+
+// Counters of every operator and the RVND neighborhood weights (bandit of --rvnd-selection ucb) of a run, as JSON
+void write_report(const std::filesystem::path &path, const ASP &asp, const Solution &solution,
+                  const std::filesystem::path &instance_file, const std::string &algorithm, const size_t seed) {
+    std::ofstream file(path);
+
+    file << "{\n  \"instance\": \"" << instance_file.stem().string() << "\",\n  \"algorithm\": \"" << algorithm
+         << "\",\n  \"seed\": " << seed << ",\n  \"objective\": " << solution.objective
+         << ",\n  \"time_to_best\": " << asp.time_to_best() << ",\n  \"revisit_rate\": " << asp.revisit_rate()
+         << ",\n  \"moves_per_pass\": " << asp.moves_per_pass() << ",\n  \"operators\": [";
+
+    for (size_t i = 0; i < ASP::NUM_OPERATORS; ++i) {
+        const auto op = static_cast<ASP::Operator>(i);
+        const ASP::OperatorStatistics &statistics = asp.operator_statistics()[i];
+
+        file << (i > 0 ? "," : "") << "\n    {\"name\": \"" << ASP::operator_name(op) << "\", \"kind\": \""
+             << ASP::operator_kind(op) << "\", \"calls\": " << statistics.calls
+             << ", \"evaluated\": " << statistics.evaluated << ", \"pruned\": " << statistics.pruned
+             << ", \"shortcuts\": " << statistics.shortcuts << ", \"improvements\": " << statistics.improvements
+             << ", \"total_gain\": " << statistics.total_gain << ", \"total_time_us\": " << statistics.total_time_us
+             << "}";
+    }
+
+    // The neighborhoods of RVND are the first best improvement operators
+    const auto weights = asp.neighborhood_weights();
+
+    file << "\n  ],\n  \"neighborhood_selection\": \""
+         << (asp.neighborhood_selection == ASP::NeighborhoodSelection::UCB ? "ucb" : "uniform")
+         << "\",\n  \"neighborhood_weights\": [";
+
+    for (size_t i = 0; i < ASP::NUM_NEIGHBORHOODS; ++i) {
+        const ASP::NeighborhoodStatistics &statistics = asp.neighborhood_statistics()[i];
+
+        file << (i > 0 ? "," : "") << "\n    {\"name\": \"" << ASP::operator_name(static_cast<ASP::Operator>(i))
+             << "\", \"weight\": " << weights[i] << ", \"calls\": " << statistics.calls
+             << ", \"improvements\": " << statistics.improvements << ", \"total_gain\": " << statistics.total_gain
+             << ", \"total_time_us\": " << statistics.total_time_us
+             << ", \"total_reward\": " << statistics.total_reward << "}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
     argparse::ArgumentParser program("ASP");
 
-    srand(time(nullptr));
-
     program.add_argument("instance").help("Path to the input file").required();
     program.add_argument("--grasp")
         .help("Number of GRASP iterations")
-        .default_value("1")   // or no default if you want it required
+        .default_value(size_t{1}) // or no default if you want it required
         .scan<'i', size_t>(); // 'i' means integer
 
-    program.add_argument("--ils").help("Number of ILS iterations").default_value("10").scan<'i', size_t>();
+    program.add_argument("--ils").help("Number of ILS iterations").default_value(size_t{10}).scan<'i', size_t>();
 
     program.add_argument("--alpha")
         .help("Alpha value for GRASP (0.0 to 1.0)")
-        .default_value("0.01")
+        .default_value(0.01)
         .scan<'g', double>(); // 'g' means double (float)
 
+    program.add_argument("--seed")
+        .help("Seed of the random generator, a seed and a thread count always give the same solution")
+        .default_value(size_t{0})
+        .scan<'i', size_t>();
+
+    program.add_argument("--algorithm")
+        .help("Metaheuristic used to solve the instance")
+        .default_value(std::string("gils-rvnd"))
+        .choices("gils-rvnd", "parallel-gils-rvnd", "island-gils-rvnd", "racing-gils-rvnd", "rolling-horizon",
+                 "alns", "online");
+
+    program.add_argument("--rvnd-selection")
+        .help("How RVND chooses the next neighborhood: uniformly at random or adaptively (UCB1 on gain per time)")
+        .default_value(std::string("uniform"))
+        .choices("uniform", "ucb");
+
+    program.add_argument("--time-limit")
+        .help("Wall-clock budget in seconds, the best solution found so far is returned when it expires (0: no limit)")
+        .default_value(0.0)
+        .scan<'g', double>();
+
+    program.add_argument("--initial-solution")
+        .help("Solution file (see --output) the first GILS-RVND iteration starts from instead of a construction");
+
+    program.add_argument("--output").help("Write the best solution to this file, in a machine-readable format");
+
+    program.add_argument("--report")
+        .help("Write the counters of every neighborhood, perturbation and construction (calls, moves evaluated and "
+              "pruned, improvements, gain, time) and the RVND neighborhood weights to this file, as JSON");
+
+    program.add_argument("--trace")
+        .help("Write the convergence of GILS-RVND (parallel or not) or ALNS to this CSV file: elapsed time, iteration, "
+              "ILS iteration, incumbent and best objective at each change of the incumbent");
+
+    program.add_argument("--trace-capacity")
+        .help("Trace points kept in memory, the oldest are overwritten past it")
+        .default_value(size_t{65536})
+        .scan<'i', size_t>();
+
+    program.add_argument("--progress")
+        .help("Print the progress of GILS-RVND at most every this many seconds (0: never)")
+        .default_value(0.0)
+        .scan<'g', double>();
+
+    program.add_argument("--checkpoint")
+        .help("GILS-RVND saves its state to this file periodically, to be continued with --resume");
+
+    program.add_argument("--checkpoint-interval")
+        .help("Seconds between two checkpoints")
+        .default_value(5.0)
+        .scan<'g', double>();
+
+    program.add_argument("--resume")
+        .help("Continue GILS-RVND from the --checkpoint file if it exists (same instance, seed and options)")
+        .flag();
+
+    program.add_argument("--parallel-neighborhoods")
+        .help("Evaluate the moves of each neighborhood scan in parallel (OpenMP)")
+        .flag();
+
+    program.add_argument("--single-move")
+        .help("Apply only the best move of each neighborhood scan instead of every improving move on disjoint runways")
+        .flag();
+
+    program.add_argument("--construction")
+        .help("Initial solutions of the metaheuristics: lowest release time insertion with a random runway weighted "
+              "by the start time, lowest release time insertion, or regret-k insertion (deterministic)")
+        .default_value(std::string("rand-lowest-release-time"))
+        .choices("rand-lowest-release-time", "lowest-release-time", "regret");
+
+    program.add_argument("--regret-k")
+        .help("Runways compared by the regret construction")
+        .default_value(size_t{2})
+        .scan<'i', size_t>();
+
+    program.add_argument("--acceptance")
+        .help("Which perturbed local optima the ILS continues from: only new local bests, threshold accepting, late "
+              "acceptance hill climbing or simulated annealing (ALNS anneals when strict)")
+        .default_value(std::string("strict"))
+        .choices("strict", "threshold", "lahc", "annealing");
+
+    program.add_argument("--acceptance-ratio")
+        .help("Initial threshold or temperature of the acceptance criterion, as a fraction of the local best objective")
+        .default_value(0.005)
+        .scan<'g', double>();
+
+    program.add_argument("--lahc-length")
+        .help("History length of late acceptance hill climbing")
+        .default_value(size_t{50})
+        .scan<'i', size_t>();
+
+    program.add_argument("--construction-batch")
+        .help("Starting solutions built in parallel per GILS-RVND iteration, only the best one goes to the ILS")
+        .default_value(size_t{1})
+        .scan<'i', size_t>();
+
+    program.add_argument("--screening-calls")
+        .help("Neighborhood scans of the truncated RVND that screens the batch (0: screen by objective)")
+        .default_value(size_t{0})
+        .scan<'i', size_t>();
+
+    program.add_argument("--elite-size")
+        .help("Size of the elite pool used for path relinking in GILS-RVND (0 disables path relinking)")
+        .default_value(size_t{10})
+        .scan<'i', size_t>();
+
+    program.add_argument("--migration-interval")
+        .help("ILS iterations between two migrations of the island model")
+        .default_value(size_t{50})
+        .scan<'i', size_t>();
+
+    program.add_argument("--racing-factor")
+        .help("Racing GILS-RVND keeps the best 1/factor of the starts after each round and gives them factor times "
+              "more ILS iterations")
+        .default_value(size_t{2})
+        .scan<'i', size_t>();
+
+    program.add_argument("--window-size")
+        .help("Flights, by release time, of each window of the rolling horizon")
+        .default_value(size_t{100})
+        .scan<'i', size_t>();
+
+    program.add_argument("--window-overlap")
+        .help("Flights of a rolling horizon window solved again in the next window")
+        .default_value(size_t{25})
+        .scan<'i', size_t>();
+
+    program.add_argument("--region-size")
+        .help("Flights around each change repaired by the online mode")
+        .default_value(size_t{40})
+        .scan<'i', size_t>();
+
+    program.add_argument("--lns-iterations")
+        .help("Number of ALNS iterations")
+        .default_value(size_t{1000})
+        .scan<'i', size_t>();
+
+    program.add_argument("--destroy-ratio")
+        .help("Maximum fraction of the flights removed by an ALNS destroy operator")
+        .default_value(0.1)
+        .scan<'g', double>();
+
     try {
         program.parse_args(argc, argv);
     } catch (const std::exception &e) {
@@ -43,18 +234,147 @@ int main(int argc, char *argv[]) {
 
     auto alpha = program.get<double>("--alpha");
 
+    auto algorithm = program.get<std::string>("--algorithm");
+
     Instance instance(instance_file_path);
 
     /*instance.print();*/
 
-    ASP asp(instance);
+    ASP asp(instance, program.get<size_t>("--seed"));
+
+    if (program.get<std::string>("--rvnd-selection") == "ucb") {
+        asp.neighborhood_selection = ASP::NeighborhoodSelection::UCB;
+    }
 
-    Solution s2 = asp.GILS_RVND(grasp_iterations, ils_iterations, alpha);
+    const auto construction = program.get<std::string>("--construction");
+    if (construction == "lowest-release-time") {
+        asp.construction = ASP::Construction::LowestReleaseTime;
+    } else if (construction == "regret") {
+        asp.construction = ASP::Construction::Regret;
+    }
+    asp.regret_k = program.get<size_t>("--regret-k");
+
+    const auto acceptance = program.get<std::string>("--acceptance");
+    if (acceptance == "threshold") {
+        asp.acceptance = ASP::Acceptance::Threshold;
+    } else if (acceptance == "lahc") {
+        asp.acceptance = ASP::Acceptance::LateAcceptance;
+    } else if (acceptance == "annealing") {
+        asp.acceptance = ASP::Acceptance::SimulatedAnnealing;
+    }
+    asp.acceptance_ratio = program.get<double>("--acceptance-ratio");
+    asp.late_acceptance_length = program.get<size_t>("--lahc-length");
+
+    asp.construction_batch = program.get<size_t>("--construction-batch");
+    asp.screening_calls = program.get<size_t>("--screening-calls");
+    asp.elite_size = program.get<size_t>("--elite-size");
+    asp.time_limit = program.get<double>("--time-limit");
+    asp.parallel_neighborhoods = program.get<bool>("--parallel-neighborhoods");
+    asp.multi_move = !program.get<bool>("--single-move");
+    asp.progress_interval = program.get<double>("--progress");
+    if (program.present("--trace")) asp.trace_capacity = std::max<size_t>(1, program.get<size_t>("--trace-capacity"));
+
+    if (auto initial_solution = program.present("--initial-solution")) {
+        try {
+            asp.initial_solution = Solution::read_sequences(*initial_solution);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        if (asp.initial_solution.size() != instance.get_num_runways()) {
+            std::cerr << "Initial solution and instance have different numbers of runways\n";
+            return 1;
+        }
+    }
+
+    if (auto checkpoint = program.present("--checkpoint")) {
+        asp.checkpoint_file = *checkpoint;
+        asp.checkpoint_interval = program.get<double>("--checkpoint-interval");
+        asp.resume = program.get<bool>("--resume");
+    } else if (program.get<bool>("--resume")) {
+        std::cerr << "--resume requires --checkpoint\n";
+        return 1;
+    }
+
+    if (algorithm == "online") {
+        // Replays a stand-in event stream of the instance's flights, repairing the schedule after each event
+        OnlineASP online(instance, program.get<size_t>("--seed"));
+        online.region_size = program.get<size_t>("--region-size");
+        online.max_ils_iterations = ils_iterations;
+        online.time_limit = asp.time_limit;
+
+        const std::vector<FlightEvent> events = stand_in_event_stream(instance, program.get<size_t>("--seed"));
+        double total_ms = 0;
+        double max_ms = 0;
+
+        std::cout << ">> Online (" << events.size() << " events)\n";
+
+        for (const FlightEvent &event : events) {
+            const auto start = std::chrono::steady_clock::now();
+            online.apply(event);
+            const double ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            total_ms += ms;
+            max_ms = std::max(max_ms, ms);
+        }
+        assert(online.test_schedule());
+
+        online.print_runway();
+        std::cout << "Objective: " << online.objective() << '\n';
+        std::cout << "Average event time: " << total_ms / static_cast<double>(events.size()) << " ms\n";
+        std::cout << "Slowest event time: " << max_ms << " ms\n";
+        return 0;
+    }
+
+    Solution s2;
+
+    if (algorithm == "parallel-gils-rvnd") {
+        s2 = asp.parallel_GILS_RVND(grasp_iterations, ils_iterations, alpha);
+    } else if (algorithm == "island-gils-rvnd") {
+        s2 = asp.island_GILS_RVND(grasp_iterations, ils_iterations,
+                                  std::max<size_t>(1, program.get<size_t>("--migration-interval")));
+    } else if (algorithm == "racing-gils-rvnd") {
+        s2 = asp.racing_GILS_RVND(grasp_iterations, ils_iterations, program.get<size_t>("--racing-factor"));
+    } else if (algorithm == "rolling-horizon") {
+        s2 = asp.rolling_horizon(ils_iterations, program.get<size_t>("--window-size"),
+                                 program.get<size_t>("--window-overlap"));
+    } else if (algorithm == "alns") {
+        s2 = asp.ALNS(program.get<size_t>("--lns-iterations"), program.get<double>("--destroy-ratio"));
+    } else {
+        try {
+            s2 = asp.GILS_RVND(grasp_iterations, ils_iterations, alpha);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
 
     s2.print_runway();
 
     std::cout << "Objective: " << s2.objective << '\n';
 
+    if (auto output = program.present("--output")) {
+        s2.write(*output);
+    }
+    if (auto report = program.present("--report")) {
+        write_report(*report, asp, s2, instance_file_path, algorithm, program.get<size_t>("--seed"));
+    }
+    if (auto trace = program.present("--trace")) {
+        asp.write_trace(*trace);
+    }
+    std::cout << "Time to best: " << asp.time_to_best() << " s\n";
+    std::cout << "Revisit rate: " << asp.revisit_rate() << '\n';
+    std::cout << "Moves per pass: " << asp.moves_per_pass() << '\n';
+
+    if (asp.acceptance != ASP::Acceptance::Strict or algorithm == "alns") {
+        std::cout << "Worse solutions accepted: " << asp.accepted_worse() << '\n';
+    }
+
+    if (asp.neighborhood_selection == ASP::NeighborhoodSelection::UCB) {
+        asp.print_neighborhood_weights();
+    }
+
     // Solution s1 = asp.GILS_VND(1, 50, 0);
     // s1.print();
 
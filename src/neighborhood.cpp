@@ -1,23 +1,28 @@
 #include "ASP.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 
 bool ASP::best_improvement_intra_swap(Solution &solution) {
-    uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
-    size_t best_flight_i = 0;
-    size_t best_flight_j = 0;
-    size_t best_runway_i = 0;
-
-    uint32_t penalty = 0;         // Penalty of the new sequence after a swap
-    uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
+    OperatorScope scope(*this, Operator::BestImprovementIntraSwap, &solution);
+    m_moves.assign(m_instance.get_num_runways(), Move{});
 
+    // Each runway is scanned by a single thread, so the swaps below never touch a runway shared between threads
+#pragma omp parallel for schedule(dynamic) if (parallel_neighborhoods)
     for (size_t runway_i = 0; runway_i < m_instance.get_num_runways(); ++runway_i) {
+        Move &best_move = m_moves[runway_i];
+        Move::Counters counters; // Stored once the scan of the runway ends, so that they stay in registers
+
+        uint32_t penalty = 0;         // Penalty of the new sequence after a swap
+        uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
+
         uint32_t original_penalty =
             solution.runways[runway_i].penalty; // Original penalty of the runway's flight sequence
 
@@ -30,9 +35,11 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
         for (size_t flight_i = 0; flight_i < sequence.size() - 1; flight_i++) {
 
             for (size_t flight_j = flight_i + 1; flight_j < sequence.size(); flight_j++) {
-                
+                counters.evaluated++;
+
                 if (sequence[flight_j].get().get_release_time() == sequence[flight_j].get().start_time) {
                     // Then we already now that this is a worse solution
+                    counters.pruned++;
                     continue;
                 }
                 
@@ -72,6 +79,7 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
                     
                     if (current_flight.start_time == prev_start_time) {
                         // Nothing gonna change until fligth_j - 1
+                        counters.shortcuts++;
                         penalty += solution.runways[runway_i].prefix_penalty[flight_j] - solution.runways[runway_i].prefix_penalty[k];
                         prev_start_time = sequence[flight_j - 1].get().start_time;
                         break;
@@ -86,6 +94,7 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
                 // {Flight_j}
                 if (penalty >= original_penalty) {
                     std::swap(sequence[flight_i], sequence[flight_j]); // Undo the swap to restore the original sequence
+                    counters.pruned++;
                     continue;
                 } else {
                     Flight &current_flight = sequence[flight_j].get();
@@ -104,7 +113,10 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
 
                 // [Flight_j + 1, Last]
                 for (size_t k = flight_j + 1; k < sequence.size(); k++) {
-                    if (penalty >= original_penalty) break;
+                    if (penalty >= original_penalty) {
+                        counters.pruned++;
+                        break;
+                    }
                     
                     Flight &current_flight = sequence[k].get();
                     Flight &prev_flight = sequence[k - 1].get();
@@ -118,6 +130,7 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
                     
                     if (current_flight.start_time == prev_start_time) {
                         // Nothing gonna change until end
+                        counters.shortcuts++;
                         penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                         break;
                     } else {
@@ -127,25 +140,38 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
                 }
 
 
-                if (penalty < original_penalty && original_penalty - penalty > delta) {
-                    delta = original_penalty - penalty;
-                    best_flight_i = flight_i;
-                    best_flight_j = flight_j;
-                    best_runway_i = runway_i;
+                if (penalty < original_penalty && original_penalty - penalty > best_move.delta) {
+                    best_move.delta = original_penalty - penalty;
+                    best_move.flight_i = flight_i;
+                    best_move.flight_j = flight_j;
+                    best_move.runway_i = runway_i;
+                    best_move.runway_j = runway_i;
                 }
 
                 std::swap(sequence[flight_i], sequence[flight_j]); // Undo the swap to restore the original sequence
             }
         }
+        best_move.counters = counters;
     }
 
-    // Apply the best swap found
-    if (delta > 0) {
+    scope.count_moves(m_moves);
+    const std::vector<Move> &moves = select_moves();
+
+    // Apply the selected swaps, each one touches its own runways
+    for (const Move &move : moves) {
+        const uint32_t delta = move.delta;
+        size_t best_flight_i = move.flight_i;
+        const size_t best_flight_j = move.flight_j;
+        const size_t best_runway_i = move.runway_i;
+
         Runway &best_runway = solution.runways[best_runway_i];
 
         best_runway.sequence[best_flight_i].get().position = best_flight_j;
         best_runway.sequence[best_flight_j].get().position = best_flight_i;
+
+        solution.hash ^= best_runway.swap_hash(best_flight_i, best_flight_j);
         std::swap(solution.runways[best_runway_i].sequence[best_flight_i], solution.runways[best_runway_i].sequence[best_flight_j]);
+        solution.hash ^= best_runway.swap_hash(best_flight_i, best_flight_j);
 
         if (best_flight_i == 0) {
             Flight &current_flight = best_runway.sequence.front().get();
@@ -171,150 +197,93 @@ bool ASP::best_improvement_intra_swap(Solution &solution) {
         best_runway.penalty -= delta;
         solution.objective -= delta;
         assert(solution.test_feasibility(m_instance));
-
-        return true;
     }
-    return false;
+    return !moves.empty();
 }
 
 bool ASP::best_improvement_inter_swap(Solution &solution) {
-    size_t best_flight_i = 0;
-    size_t best_flight_j = 0;
-    size_t best_runway_i = 0;
-    size_t best_runway_j = 0;
-
-    uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
-    uint32_t penalty_i = 0;
-    uint32_t penalty_j = 0;
-    uint32_t prev_start_time_i = 0;
-    uint32_t prev_start_time_j = 0;
-
-    for (size_t runway_i = 0; runway_i < m_instance.get_num_runways() - 1; ++runway_i) {
-        for (size_t runway_j = runway_i + 1; runway_j < m_instance.get_num_runways(); ++runway_j) {
+    OperatorScope scope(*this, Operator::BestImprovementInterSwap, &solution);
+    const size_t num_runways = m_instance.get_num_runways();
 
-            // Get all combinations (flight_i, flight_j)
-            for (size_t flight_i = 0; flight_i < solution.runways[runway_i].sequence.size(); ++flight_i) {
-                for (size_t flight_j = 0; flight_j < solution.runways[runway_j].sequence.size(); ++flight_j) {
-
-                    uint32_t original_penalty_i = solution.runways[runway_i].penalty;
-                    uint32_t original_penalty_j = solution.runways[runway_j].penalty;
-
-                    std::swap(solution.runways[runway_i].sequence[flight_i],
-                              solution.runways[runway_j].sequence[flight_j]);
-
-                    penalty_i = solution.runways[runway_i].prefix_penalty[flight_i];
-                    penalty_j = solution.runways[runway_j].prefix_penalty[flight_j];
-
-                    // Penalty runway_i
-                    if (flight_i == 0) {
-                        prev_start_time_i = solution.runways[runway_i].sequence[0].get().get_release_time();
-                    } else {
-                        Flight &current_flight = solution.runways[runway_i].sequence[flight_i].get();
-                        Flight &prev_flight = solution.runways[runway_i].sequence[flight_i - 1].get();
-
-                        prev_start_time_i = prev_flight.start_time;
+    m_moves.assign(num_runways * num_runways, Move{});
 
-                        // prev_start_time_i becomes current_start_time_i
-                        prev_start_time_i =
-                            std::max(current_flight.get_release_time(),
-                                     prev_start_time_i + prev_flight.get_runway_occupancy_time() +
-                                         m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
-                        penalty_i += (prev_start_time_i - current_flight.get_release_time()) *
-                                     current_flight.get_delay_penalty();
-                    }
+    // The scan only reads the solution, each runway pair is scanned by a single thread
+#pragma omp parallel for schedule(dynamic) if (parallel_neighborhoods)
+    for (size_t runway_pair = 0; runway_pair < num_runways * num_runways; ++runway_pair) {
+        const size_t runway_i = runway_pair / num_runways;
+        const size_t runway_j = runway_pair % num_runways;
 
-                    for (size_t k = flight_i + 1; k < solution.runways[runway_i].sequence.size();
-                         k++) {
-                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
-
-                        Flight &current_flight = solution.runways[runway_i].sequence[k].get();
-                        Flight &prev_flight = solution.runways[runway_i].sequence[k - 1].get();
+        if (runway_i >= runway_j) continue;
 
-                        // prev_start_time_i becomes current_start_time_i
-                        prev_start_time_i =
-                            std::max(current_flight.get_release_time(),
-                                     prev_start_time_i + prev_flight.get_runway_occupancy_time() +
-                                         m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
-                        
-                        if (current_flight.start_time == prev_start_time_i) {
-                            // Nothing gonna change until end
-                            penalty_i += solution.runways[runway_i].prefix_penalty[solution.runways[runway_i].sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
-                            break;
-                        } else {
-                            penalty_i += (prev_start_time_i - current_flight.get_release_time()) *
-                                     current_flight.get_delay_penalty();
-                        }
-                    }
+        const Runway &runway_a = solution.runways[runway_i];
+        const Runway &runway_b = solution.runways[runway_j];
+        const uint32_t original_penalty = runway_a.penalty + runway_b.penalty;
 
-                    // Penalty runway_j
-                    if (flight_j == 0) {
-                        prev_start_time_j = solution.runways[runway_j].sequence[0].get().get_release_time();
-                    } else {
-                        Flight &current_flight = solution.runways[runway_j].sequence[flight_j].get();
-                        Flight &prev_flight = solution.runways[runway_j].sequence[flight_j - 1].get();
+        Move &best_move = m_moves[runway_pair];
 
-                        prev_start_time_j = prev_flight.start_time;
+        Move::Counters counters; // Stored once the scan of the runway ends, so that they stay in registers
 
-                        // prev_start_time_j becomes current_start_time_j
-                        prev_start_time_j =
-                            std::max(current_flight.get_release_time(),
-                                     prev_start_time_j + prev_flight.get_runway_occupancy_time() +
-                                         m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
-                        penalty_j += (prev_start_time_j - current_flight.get_release_time()) *
-                                     current_flight.get_delay_penalty();
-                    }
+        // Get all combinations (flight_i, flight_j)
+        for (size_t flight_i = 0; flight_i < runway_a.sequence.size(); ++flight_i) {
+            for (size_t flight_j = 0; flight_j < runway_b.sequence.size(); ++flight_j) {
+                counters.evaluated++;
 
-                    for (size_t k = flight_j + 1; k < solution.runways[runway_j].sequence.size();
-                         k++) {
-                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
-                        
-                        Flight &current_flight = solution.runways[runway_j].sequence[k].get();
-                        Flight &prev_flight = solution.runways[runway_j].sequence[k - 1].get();
+                const Flight &flight_a = runway_a.sequence[flight_i].get();
+                const Flight &flight_b = runway_b.sequence[flight_j].get();
 
-                        // prev_start_time_j becomes current_start_time_j
-                        prev_start_time_j =
-                            std::max(current_flight.get_release_time(),
-                                     prev_start_time_j + prev_flight.get_runway_occupancy_time() +
-                                         m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
-                        
-                        if (current_flight.start_time == prev_start_time_j) {
-                            // Nothing gonna change until end
-                            penalty_j += solution.runways[runway_j].prefix_penalty[solution.runways[runway_j].sequence.size()] - solution.runways[runway_j].prefix_penalty[k];
-                            break;
-                        } else {
-                            penalty_j += (prev_start_time_j - current_flight.get_release_time()) *
-                                     current_flight.get_delay_penalty();
-                        }
-                    }
+                // Penalty runway_i with flight_b in place of flight_a (stops once the swap can not improve)
+                const uint32_t penalty_i = runway_a.replacement_penalty(
+                    m_instance, flight_i, flight_b, original_penalty - runway_b.prefix_penalty[flight_j]);
 
-                    if (penalty_i + penalty_j < original_penalty_i + original_penalty_j &&
-                        original_penalty_i + original_penalty_j - (penalty_i + penalty_j) > delta) {
-                        delta = original_penalty_i + original_penalty_j - penalty_i - penalty_j;
-                        best_runway_i = runway_i;
-                        best_runway_j = runway_j;
-                        best_flight_i = flight_i;
-                        best_flight_j = flight_j;
-                    }
+                if (penalty_i >= original_penalty - runway_b.prefix_penalty[flight_j]) {
+                    counters.pruned++;
+                    continue;
+                }
 
-                    // Undo the swap to restore the original sequence
-                    std::swap(solution.runways[runway_i].sequence[flight_i],
-                              solution.runways[runway_j].sequence[flight_j]);
+                // Penalty runway_j with flight_a in place of flight_b
+                const uint32_t penalty_j =
+                    runway_b.replacement_penalty(m_instance, flight_j, flight_a, original_penalty - penalty_i);
+
+                if (penalty_i + penalty_j < original_penalty &&
+                    original_penalty - (penalty_i + penalty_j) > best_move.delta) {
+                    best_move.delta = original_penalty - penalty_i - penalty_j;
+                    best_move.runway_i = runway_i;
+                    best_move.runway_j = runway_j;
+                    best_move.flight_i = flight_i;
+                    best_move.flight_j = flight_j;
                 }
             }
         }
+
+        best_move.counters = counters;
     }
 
-    // Apply the best swap found
-    if (delta > 0) {
+    scope.count_moves(m_moves);
+    const std::vector<Move> &moves = select_moves();
+
+    // Apply the selected swaps, each one touches its own runways
+    for (const Move &move : moves) {
+        const uint32_t delta = move.delta;
+        size_t best_flight_i = move.flight_i;
+        size_t best_flight_j = move.flight_j;
+        const size_t best_runway_i = move.runway_i;
+        const size_t best_runway_j = move.runway_j;
+
         solution.runways[best_runway_i].sequence[best_flight_i].get().position = best_flight_j;
         solution.runways[best_runway_i].sequence[best_flight_i].get().runway = best_runway_j;
 
         solution.runways[best_runway_j].sequence[best_flight_j].get().position = best_flight_i;
         solution.runways[best_runway_j].sequence[best_flight_j].get().runway = best_runway_i;
 
+        const uint64_t original_links = solution.runways[best_runway_i].neighbors_hash(best_flight_i) ^
+                                        solution.runways[best_runway_j].neighbors_hash(best_flight_j);
+
         std::swap(solution.runways[best_runway_i].sequence[best_flight_i],
                   solution.runways[best_runway_j].sequence[best_flight_j]);
 
+        solution.hash ^= original_links ^ solution.runways[best_runway_i].neighbors_hash(best_flight_i) ^
+                         solution.runways[best_runway_j].neighbors_hash(best_flight_j);
+
         // Update prefix best_runway_i
         if (best_flight_i == 0) {
             Flight &current_flight = solution.runways[best_runway_i].sequence[0].get();
@@ -367,37 +336,44 @@ bool ASP::best_improvement_inter_swap(Solution &solution) {
         solution.runways[best_runway_j].penalty = solution.runways[best_runway_j].prefix_penalty.back();
         solution.objective -= delta;
         assert(solution.test_feasibility(m_instance));
-        return true;
     }
-    return false;
+    return !moves.empty();
 }
 
 bool ASP::best_improvement_inter_move(Solution &solution) {
+    OperatorScope scope(*this, Operator::BestImprovementInterMove, &solution);
     // Previous location best_flight_i in best_runway_i
     //      - If there was a flight in best_flight_i + 1 the move all to the right to --
     // New location best_flight_j in best_runway_j
     //      - If there was a flight at best_flight_j in best_runway_j then move all to teh right to ++ 
-    size_t best_flight_i = 0;
-    size_t best_flight_j = 0;
+    const size_t num_runways = m_instance.get_num_runways();
 
-    size_t best_runway_i = 0;
-    size_t best_runway_j = 0;
+    m_moves.assign(num_runways * num_runways, Move{});
 
-    uint32_t delta = 0;
-    uint32_t penalty_i = 0;
-    uint32_t penalty_j = 0;
-    uint32_t prev_start_time_i = 0;
-    uint32_t prev_start_time_j = 0;
+    // The scan only reads the solution, each ordered runway pair is scanned by a single thread
+#pragma omp parallel for schedule(dynamic) if (parallel_neighborhoods)
+    for (size_t runway_pair = 0; runway_pair < num_runways * num_runways; ++runway_pair) {
+        const size_t runway_i = runway_pair / num_runways;
+        const size_t runway_j = runway_pair % num_runways;
 
-    for (size_t runway_i = 0; runway_i < m_instance.get_num_runways(); ++runway_i) {
         if (solution.runways[runway_i].sequence.size() == 1) continue; // Prevents a runway to be empty
-        for (size_t runway_j = 0; runway_j < m_instance.get_num_runways(); ++runway_j) {
-            if (runway_i == runway_j) continue;
+        if (runway_i == runway_j) continue;
+
+        Move &best_move = m_moves[runway_pair];
 
+        Move::Counters counters; // Stored once the scan of the runway ends, so that they stay in registers
+
+        uint32_t penalty_i = 0;
+        uint32_t penalty_j = 0;
+        uint32_t prev_start_time_i = 0;
+        uint32_t prev_start_time_j = 0;
+
+        {
             // Get all combinations (flight_i, flight_j)
             for (size_t flight_i = 0; flight_i < solution.runways[runway_i].sequence.size(); ++flight_i) {
                 for (size_t flight_j = 0; flight_j < solution.runways[runway_j].sequence.size() + 1; ++flight_j) {
-                    
+                    counters.evaluated++;
+
                     /**
                     // Common lead to worse solution
                     // Because usually the penality of runway_j is increasead
@@ -461,6 +437,7 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
                         
                         if (current_flight.start_time == prev_start_time_i) {
                             // Nothing gonna change until end
+                            counters.shortcuts++;
                             penalty_i += solution.runways[runway_i].prefix_penalty[solution.runways[runway_i].sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
                         } else {
@@ -514,7 +491,10 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
                     }
 
                     for (size_t k = flight_j + 1; k < solution.runways[runway_j].sequence.size(); k++) {
-                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
+                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) {
+                            counters.pruned++;
+                            break;
+                        }
                         
                         Flight &current_flight = solution.runways[runway_j].sequence[k].get();
                         Flight &prev_flight = solution.runways[runway_j].sequence[k - 1].get();
@@ -527,6 +507,7 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
                         
                         if (current_flight.start_time == prev_start_time_j) {
                             // Nothing gonna change until end
+                            counters.shortcuts++;
                             penalty_j += solution.runways[runway_j].prefix_penalty[solution.runways[runway_j].sequence.size()] - solution.runways[runway_j].prefix_penalty[k];
                             break;
                         } else {
@@ -536,20 +517,33 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
                     }
 
                     if (penalty_i + penalty_j < original_penalty_i + original_penalty_j &&
-                        original_penalty_i + original_penalty_j - (penalty_i + penalty_j) > delta) {
-                        delta = original_penalty_i + original_penalty_j - penalty_i - penalty_j;
-                        best_runway_i = runway_i;
-                        best_runway_j = runway_j;
-                        best_flight_i = flight_i;
-                        best_flight_j = flight_j;
+                        original_penalty_i + original_penalty_j - (penalty_i + penalty_j) > best_move.delta) {
+                        best_move.delta = original_penalty_i + original_penalty_j - penalty_i - penalty_j;
+                        best_move.runway_i = runway_i;
+                        best_move.runway_j = runway_j;
+                        best_move.flight_i = flight_i;
+                        best_move.flight_j = flight_j;
                     }
                 }
             }
         }
+
+        best_move.counters = counters;
     }
 
-    // Apply the best move found
-    if (delta > 0) {
+    scope.count_moves(m_moves);
+    const std::vector<Move> &moves = select_moves();
+
+    // Apply the selected moves, each one touches its own runways
+    for (const Move &move : moves) {
+        const uint32_t delta = move.delta;
+        size_t best_flight_i = move.flight_i;
+        size_t best_flight_j = move.flight_j;
+        const size_t best_runway_i = move.runway_i;
+        const size_t best_runway_j = move.runway_j;
+
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_i);
+
         solution.runways[best_runway_i].sequence[best_flight_i].get().position = best_flight_j;
         solution.runways[best_runway_i].sequence[best_flight_i].get().runway = best_runway_j;
         solution.runways[best_runway_i].prefix_penalty.pop_back();
@@ -575,6 +569,7 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
             solution.runways[best_runway_i].sequence[k].get().position = k;
         }
         solution.runways[best_runway_i].sequence.pop_back();
+        solution.hash ^= solution.runways[best_runway_j].removal_hash(best_flight_j);
         
         // Update prefix best_runway_i
         if (best_flight_i == 0) {
@@ -625,22 +620,23 @@ bool ASP::best_improvement_inter_move(Solution &solution) {
         solution.runways[best_runway_j].penalty = solution.runways[best_runway_j].prefix_penalty.back();
         solution.objective -= delta;
         assert(solution.test_feasibility(m_instance));
-        return true;
     }
-    
-    return false;
+    return !moves.empty();
 }
 
 bool ASP::best_improvement_intra_move(Solution &solution) {
-    uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
-    size_t best_flight_i = 0;
-    size_t best_flight_j = 0;
-    size_t best_runway_i = 0;
-
-    uint32_t penalty = 0;         // Penalty of the new sequence after a swap
-    uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
+    OperatorScope scope(*this, Operator::BestImprovementIntraMove, &solution);
+    m_moves.assign(m_instance.get_num_runways(), Move{});
 
+    // The scan only reads the solution, each runway is scanned by a single thread
+#pragma omp parallel for schedule(dynamic) if (parallel_neighborhoods)
     for (size_t runway_i = 0; runway_i < m_instance.get_num_runways(); ++runway_i) {
+        Move &best_move = m_moves[runway_i];
+        Move::Counters counters; // Stored once the scan of the runway ends, so that they stay in registers
+
+        uint32_t penalty = 0;         // Penalty of the new sequence after a move
+        uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
+
         uint32_t original_penalty =
             solution.runways[runway_i].penalty; // Original penalty of the runway's flight sequence
 
@@ -651,6 +647,8 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
 
         for (size_t flight_i = 0; flight_i < sequence.size(); flight_i++) {
             for (size_t flight_j = 0; flight_j < sequence.size(); flight_j++) {
+                if (flight_i != flight_j) counters.evaluated++;
+
                 if (flight_i < flight_j) {
                     penalty = solution.runways[runway_i].prefix_penalty[flight_i];
 
@@ -685,6 +683,7 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            counters.shortcuts++;
                             // Nothing gonna change until fligth_j
                             penalty += solution.runways[runway_i].prefix_penalty[flight_j + 1] - solution.runways[runway_i].prefix_penalty[k];
                             prev_start_time = sequence[flight_j].get().start_time;
@@ -698,8 +697,10 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                     }
 
                     // Put fligth_i next to fligth_j
-                    if (penalty >= original_penalty) continue;
-                    else {
+                    if (penalty >= original_penalty) {
+                        counters.pruned++;
+                        continue;
+                    } else {
                         Flight &current_flight = sequence[flight_i].get();
                         Flight &prev_flight = sequence[flight_j].get();
 
@@ -729,7 +730,10 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
 
                     // [Flight_j + 2, Last]
                     for (size_t k = flight_j + 2; k < sequence.size(); k++) {
-                        if (penalty >= original_penalty) break;
+                        if (penalty >= original_penalty) {
+                            counters.pruned++;
+                            break;
+                        }
 
                         Flight &current_flight = sequence[k].get();
                         Flight &prev_flight = sequence[k - 1].get();
@@ -742,6 +746,7 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            counters.shortcuts++;
                             // Nothing gonna change until end
                             penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -751,11 +756,12 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                         }
                     }
 
-                    if (penalty < original_penalty && original_penalty - penalty > delta) {
-                        delta = original_penalty - penalty;
-                        best_flight_i = flight_i;
-                        best_flight_j = flight_j;
-                        best_runway_i = runway_i;
+                    if (penalty < original_penalty && original_penalty - penalty > best_move.delta) {
+                        best_move.delta = original_penalty - penalty;
+                        best_move.flight_i = flight_i;
+                        best_move.flight_j = flight_j;
+                        best_move.runway_i = runway_i;
+                        best_move.runway_j = runway_i;
                     }
                 } else if (flight_i > flight_j) {
                     penalty = solution.runways[runway_i].prefix_penalty[flight_j];
@@ -817,6 +823,7 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            counters.shortcuts++;
                             // Nothing gonna change until fligth_i - 1
                             penalty += solution.runways[runway_i].prefix_penalty[flight_i] - solution.runways[runway_i].prefix_penalty[k];
                             prev_start_time = sequence[flight_i - 1].get().start_time;
@@ -830,8 +837,10 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                     }
 
                     // Connect fligth_i - 1 && fligth_i + 1 if possible
-                    if (penalty >= original_penalty) continue;
-                    else if (flight_i + 1 < sequence.size()){
+                    if (penalty >= original_penalty) {
+                        counters.pruned++;
+                        continue;
+                    } else if (flight_i + 1 < sequence.size()){
                         Flight &current_flight = sequence[flight_i + 1].get();
                         Flight &prev_flight = sequence[flight_i - 1].get();
 
@@ -847,7 +856,10 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
 
                     // [Flight_i + 2, Last]
                     for (size_t k = flight_i + 2; k < sequence.size(); k++) {
-                        if (penalty >= original_penalty) break;
+                        if (penalty >= original_penalty) {
+                            counters.pruned++;
+                            break;
+                        }
 
                         Flight &current_flight = sequence[k].get();
                         Flight &prev_flight = sequence[k - 1].get();
@@ -860,6 +872,7 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            counters.shortcuts++;
                             // Nothing gonna change until last
                             penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -870,22 +883,34 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
 
                     }
 
-                    if (penalty < original_penalty && original_penalty - penalty > delta) {
-                        delta = original_penalty - penalty;
-                        best_flight_i = flight_i;
-                        best_flight_j = flight_j;
-                        best_runway_i = runway_i;
+                    if (penalty < original_penalty && original_penalty - penalty > best_move.delta) {
+                        best_move.delta = original_penalty - penalty;
+                        best_move.flight_i = flight_i;
+                        best_move.flight_j = flight_j;
+                        best_move.runway_i = runway_i;
+                        best_move.runway_j = runway_i;
                     }
                 }
 
             }
         }
+        best_move.counters = counters;
     }
 
-    // Apply the best move found
-    if (delta > 0) {
+    scope.count_moves(m_moves);
+    const std::vector<Move> &moves = select_moves();
+
+    // Apply the selected moves, each one touches its own runways
+    for (const Move &move : moves) {
+        const uint32_t delta = move.delta;
+        const size_t best_flight_i = move.flight_i;
+        const size_t best_flight_j = move.flight_j;
+        const size_t best_runway_i = move.runway_i;
+
         std::vector<std::reference_wrapper<Flight>> &sequence = solution.runways[best_runway_i].sequence;
 
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_i);
+
         if (best_flight_i < best_flight_j) {
             Flight &tmp = sequence[best_flight_i].get();
             
@@ -908,9 +933,11 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
             sequence[best_flight_j].get().position = best_flight_j; 
         }
 
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_j);
+
         sequence[0].get().start_time = sequence[0].get().get_release_time();
-        prev_start_time = sequence[0].get().start_time;
-        penalty = 0;
+        uint32_t prev_start_time = sequence[0].get().start_time;
+        uint32_t penalty = 0;
 
         for (size_t k = 1; k < sequence.size(); k++) {
             Flight &current_flight = sequence[k].get();
@@ -931,19 +958,18 @@ bool ASP::best_improvement_intra_move(Solution &solution) {
         solution.runways[best_runway_i].penalty = penalty;
         solution.objective -= delta;
         assert(solution.test_feasibility(m_instance));
-        return true;
     }
-
-    return false;
+    return !moves.empty();
 }
 
 bool ASP::move_worst_flight(Solution &solution) {
+    OperatorScope scope(*this, Operator::MoveWorstFlight, &solution);
     size_t worst_flight_i = 0;
     size_t worst_penalty = 0;
     size_t penalty = 0;
 
     for (size_t i = 0; i < flights.size(); i++) {
-        penalty = (flights[i].start_time - flights[i].get_release_time()) * flights[i].get_delay_penalty();
+        penalty = flights[i].get_delay_cost();
         if (penalty > worst_penalty) {
             worst_penalty = penalty;
             worst_flight_i = i;
@@ -965,6 +991,8 @@ bool ASP::move_worst_flight(Solution &solution) {
     for (size_t runway_j = 0; runway_j < m_instance.get_num_runways(); ++runway_j) {
         if (runway_j == best_runway_i) continue;
         for (size_t flight_j = 0; flight_j < solution.runways[runway_j].sequence.size() + 1; ++flight_j) {
+            scope.statistics.evaluated++;
+
             // Get the original_penalty of the runways
             uint32_t original_penalty_i = solution.runways[best_runway_i].penalty;
             uint32_t original_penalty_j = solution.runways[runway_j].penalty;
@@ -1003,6 +1031,7 @@ bool ASP::move_worst_flight(Solution &solution) {
                                     m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                 
                 if (current_flight.start_time == prev_start_time_i) {
+                    scope.statistics.shortcuts++;
                     // Nothing gonna change until end
                     penalty_i += solution.runways[best_runway_i].prefix_penalty[solution.runways[best_runway_i].sequence.size()] - solution.runways[best_runway_i].prefix_penalty[k];
                     break;
@@ -1057,7 +1086,10 @@ bool ASP::move_worst_flight(Solution &solution) {
             }
 
             for (size_t k = flight_j + 1; k < solution.runways[runway_j].sequence.size(); k++) {
-                if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
+                if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) {
+                    scope.statistics.pruned++;
+                    break;
+                }
                 
                 Flight &current_flight = solution.runways[runway_j].sequence[k].get();
                 Flight &prev_flight = solution.runways[runway_j].sequence[k - 1].get();
@@ -1069,6 +1101,7 @@ bool ASP::move_worst_flight(Solution &solution) {
                                     m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                 
                 if (current_flight.start_time == prev_start_time_j) {
+                    scope.statistics.shortcuts++;
                     // Nothing gonna change until end
                     penalty_j += solution.runways[runway_j].prefix_penalty[solution.runways[runway_j].sequence.size()] - solution.runways[runway_j].prefix_penalty[k];
                     break;
@@ -1089,6 +1122,8 @@ bool ASP::move_worst_flight(Solution &solution) {
 
     // Apply the best move found
     if (delta > 0) {
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_i);
+
         solution.runways[best_runway_i].sequence[best_flight_i].get().position = best_flight_j;
         solution.runways[best_runway_i].sequence[best_flight_i].get().runway = best_runway_j;
         solution.runways[best_runway_i].prefix_penalty.pop_back();
@@ -1114,6 +1149,7 @@ bool ASP::move_worst_flight(Solution &solution) {
             solution.runways[best_runway_i].sequence[k].get().position = k;
         }
         solution.runways[best_runway_i].sequence.pop_back();
+        solution.hash ^= solution.runways[best_runway_j].removal_hash(best_flight_j);
         
         // Update prefix best_runway_i
         if (best_flight_i == 0) {
@@ -1163,6 +1199,7 @@ bool ASP::move_worst_flight(Solution &solution) {
         solution.runways[best_runway_i].penalty = solution.runways[best_runway_i].prefix_penalty.back();
         solution.runways[best_runway_j].penalty = solution.runways[best_runway_j].prefix_penalty.back();
         solution.objective -= delta;
+        assert(solution.test_hash());
         assert(solution.test_feasibility(m_instance));
         return true;
     }
@@ -1171,6 +1208,7 @@ bool ASP::move_worst_flight(Solution &solution) {
 }
 
 bool ASP::first_improvement_intra_swap(Solution &solution) {
+    OperatorScope scope(*this, Operator::FirstImprovementIntraSwap, &solution);
     uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
@@ -1179,7 +1217,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
     uint32_t penalty = 0;         // Penalty of the new sequence after a swap
     uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
 
-    size_t start_runway = rand() % m_instance.get_num_runways();
+    size_t start_runway = random_index(m_instance.get_num_runways());
 
     for (size_t r = 0; r < m_instance.get_num_runways(); ++r) {
         size_t runway_i = (start_runway + r) % m_instance.get_num_runways();
@@ -1194,7 +1232,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
 
         if (sequence.size() < 2) continue;
 
-        size_t start_flight = rand() % sequence.size();
+        size_t start_flight = random_index(sequence.size());
 
         // Iterate through all possible pairs of flights in the sequence to evaluate swaps
         for (size_t fi = 0; fi < sequence.size() - 1; fi++) {
@@ -1205,8 +1243,11 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
 
                 if (flight_i > flight_j) std::swap(flight_i, flight_j);
 
+                scope.statistics.evaluated++;
+
                 if (sequence[flight_j].get().get_release_time() == sequence[flight_j].get().start_time) {
                     // Then we already now that this is a worse solution
+                    scope.statistics.pruned++;
                     continue;
                 }
                 
@@ -1245,6 +1286,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
                     
                     
                     if (current_flight.start_time == prev_start_time) {
+                        scope.statistics.shortcuts++;
                         // Nothing gonna change until fligth_j - 1
                         penalty += solution.runways[runway_i].prefix_penalty[flight_j] - solution.runways[runway_i].prefix_penalty[k];
                         prev_start_time = sequence[flight_j - 1].get().start_time;
@@ -1260,6 +1302,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
                 // {Flight_j}
                 if (penalty >= original_penalty) {
                     std::swap(sequence[flight_i], sequence[flight_j]); // Undo the swap to restore the original sequence
+                    scope.statistics.pruned++;
                     continue;
                 } else {
                     Flight &current_flight = sequence[flight_j].get();
@@ -1278,7 +1321,10 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
 
                 // [Flight_j + 1, Last]
                 for (size_t k = flight_j + 1; k < sequence.size(); k++) {
-                    if (penalty >= original_penalty) break;
+                    if (penalty >= original_penalty) {
+                        scope.statistics.pruned++;
+                        break;
+                    }
                     
                     Flight &current_flight = sequence[k].get();
                     Flight &prev_flight = sequence[k - 1].get();
@@ -1291,6 +1337,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
                     
                     
                     if (current_flight.start_time == prev_start_time) {
+                        scope.statistics.shortcuts++;
                         // Nothing gonna change until end
                         penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                         break;
@@ -1323,7 +1370,10 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
 
         best_runway.sequence[best_flight_i].get().position = best_flight_j;
         best_runway.sequence[best_flight_j].get().position = best_flight_i;
+
+        solution.hash ^= best_runway.swap_hash(best_flight_i, best_flight_j);
         std::swap(solution.runways[best_runway_i].sequence[best_flight_i], solution.runways[best_runway_i].sequence[best_flight_j]);
+        solution.hash ^= best_runway.swap_hash(best_flight_i, best_flight_j);
 
         if (best_flight_i == 0) {
             Flight &current_flight = best_runway.sequence.front().get();
@@ -1348,6 +1398,7 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
 
         best_runway.penalty -= delta;
         solution.objective -= delta;
+        assert(solution.test_hash());
         assert(solution.test_feasibility(m_instance));
 
         return true;
@@ -1355,7 +1406,8 @@ bool ASP::first_improvement_intra_swap(Solution &solution) {
     return false;
 }
 
-bool ASP::first_improvement_inter_swap(Solution &solution) { 
+bool ASP::first_improvement_inter_swap(Solution &solution) {
+    OperatorScope scope(*this, Operator::FirstImprovementInterSwap, &solution);
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
     size_t best_runway_i = 0;
@@ -1367,21 +1419,22 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
     uint32_t prev_start_time_i = 0;
     uint32_t prev_start_time_j = 0;
 
-    size_t start_runway = rand() % m_instance.get_num_runways();
+    size_t start_runway = random_index(m_instance.get_num_runways());
 
     for (size_t ri = 0; ri < m_instance.get_num_runways() - 1; ++ri) {
         for (size_t rj = ri + 1; rj < m_instance.get_num_runways(); ++rj) {
             size_t runway_i = (start_runway + ri) % m_instance.get_num_runways();
             size_t runway_j = (start_runway + rj) % m_instance.get_num_runways();
 
-            size_t start_flight_i = rand() % solution.runways[runway_i].sequence.size();
-            size_t start_flight_j = rand() % solution.runways[runway_j].sequence.size();
+            size_t start_flight_i = random_index(solution.runways[runway_i].sequence.size());
+            size_t start_flight_j = random_index(solution.runways[runway_j].sequence.size());
 
             // Get all combinations (flight_i, flight_j)
             for (size_t fi = 0; fi < solution.runways[runway_i].sequence.size(); ++fi) {
                 size_t flight_i = (start_flight_i + fi) % solution.runways[runway_i].sequence.size();
                 for (size_t fj = 0; fj < solution.runways[runway_j].sequence.size(); ++fj) {
                     size_t flight_j = (start_flight_j + fj) % solution.runways[runway_j].sequence.size();
+                    scope.statistics.evaluated++;
 
                     uint32_t original_penalty_i = solution.runways[runway_i].penalty;
                     uint32_t original_penalty_j = solution.runways[runway_j].penalty;
@@ -1424,6 +1477,7 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
                                          m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                         
                         if (current_flight.start_time == prev_start_time_i) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until end
                             penalty_i += solution.runways[runway_i].prefix_penalty[solution.runways[runway_i].sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -1453,7 +1507,11 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
 
                     for (size_t k = flight_j + 1; k < solution.runways[runway_j].sequence.size();
                          k++) {
-                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
+                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) {
+                            // The scan of runway_i may have stopped on the same bound, counted here only
+                            scope.statistics.pruned++;
+                            break;
+                        }
                         
                         Flight &current_flight = solution.runways[runway_j].sequence[k].get();
                         Flight &prev_flight = solution.runways[runway_j].sequence[k - 1].get();
@@ -1465,6 +1523,7 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
                                          m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                         
                         if (current_flight.start_time == prev_start_time_j) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until end
                             penalty_j += solution.runways[runway_j].prefix_penalty[solution.runways[runway_j].sequence.size()] - solution.runways[runway_j].prefix_penalty[k];
                             break;
@@ -1504,9 +1563,15 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
         solution.runways[best_runway_j].sequence[best_flight_j].get().position = best_flight_i;
         solution.runways[best_runway_j].sequence[best_flight_j].get().runway = best_runway_i;
 
+        const uint64_t original_links = solution.runways[best_runway_i].neighbors_hash(best_flight_i) ^
+                                        solution.runways[best_runway_j].neighbors_hash(best_flight_j);
+
         std::swap(solution.runways[best_runway_i].sequence[best_flight_i],
                   solution.runways[best_runway_j].sequence[best_flight_j]);
 
+        solution.hash ^= original_links ^ solution.runways[best_runway_i].neighbors_hash(best_flight_i) ^
+                         solution.runways[best_runway_j].neighbors_hash(best_flight_j);
+
         // Update prefix best_runway_i
         if (best_flight_i == 0) {
             Flight &current_flight = solution.runways[best_runway_i].sequence[0].get();
@@ -1558,6 +1623,7 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
         solution.runways[best_runway_i].penalty = solution.runways[best_runway_i].prefix_penalty.back();
         solution.runways[best_runway_j].penalty = solution.runways[best_runway_j].prefix_penalty.back();
         solution.objective -= delta;
+        assert(solution.test_hash());
         assert(solution.test_feasibility(m_instance));
         return true;
     }
@@ -1565,6 +1631,7 @@ bool ASP::first_improvement_inter_swap(Solution &solution) {
 }
 
 bool ASP::first_improvement_inter_move(Solution &solution) {
+    OperatorScope scope(*this, Operator::FirstImprovementInterMove, &solution);
     // Previous location best_flight_i in best_runway_i
     //      - If there was a flight in best_flight_i + 1 the move all to the right to --
     // New location best_flight_j in best_runway_j
@@ -1581,8 +1648,8 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
     uint32_t prev_start_time_i = 0;
     uint32_t prev_start_time_j = 0;
 
-    size_t start_runway_i = rand() % m_instance.get_num_runways();
-    size_t start_runway_j = rand() % m_instance.get_num_runways();
+    size_t start_runway_i = random_index(m_instance.get_num_runways());
+    size_t start_runway_j = random_index(m_instance.get_num_runways());
     
     for (size_t ri = 0; ri < m_instance.get_num_runways(); ++ri) {
         
@@ -1594,14 +1661,15 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
             size_t runway_j = (start_runway_j + rj) % m_instance.get_num_runways();     
             if (runway_i == runway_j) continue;
 
-            size_t start_flight_i = rand() % solution.runways[runway_i].sequence.size();
-            size_t start_flight_j = rand() % (solution.runways[runway_j].sequence.size() + 1);
+            size_t start_flight_i = random_index(solution.runways[runway_i].sequence.size());
+            size_t start_flight_j = random_index(solution.runways[runway_j].sequence.size() + 1);
 
             // Get all combinations (flight_i, flight_j)
             for (size_t fi = 0; fi < solution.runways[runway_i].sequence.size(); ++fi) {
                 size_t flight_i = (start_flight_i + fi) % solution.runways[runway_i].sequence.size();
                 for (size_t fj = 0; fj < solution.runways[runway_j].sequence.size() + 1; ++fj) {
                     size_t flight_j = (start_flight_j + fj) % (solution.runways[runway_j].sequence.size() + 1);
+                    scope.statistics.evaluated++;
 
                     /**
                     // Common lead to worse solution
@@ -1665,6 +1733,7 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
                                          m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                         
                         if (current_flight.start_time == prev_start_time_i) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until end
                             penalty_i += solution.runways[runway_i].prefix_penalty[solution.runways[runway_i].sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -1719,7 +1788,10 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
                     }
 
                     for (size_t k = flight_j + 1; k < solution.runways[runway_j].sequence.size(); k++) {
-                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) break;
+                        if (penalty_i + penalty_j >= original_penalty_i + original_penalty_j) {
+                            scope.statistics.pruned++;
+                            break;
+                        }
                         
                         Flight &current_flight = solution.runways[runway_j].sequence[k].get();
                         Flight &prev_flight = solution.runways[runway_j].sequence[k - 1].get();
@@ -1731,6 +1803,7 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
                                          m_instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
                         
                         if (current_flight.start_time == prev_start_time_j) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until end
                             penalty_j += solution.runways[runway_j].prefix_penalty[solution.runways[runway_j].sequence.size()] - solution.runways[runway_j].prefix_penalty[k];
                             break;
@@ -1760,6 +1833,8 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
 
     // Apply the best move found
     if (delta > 0) {
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_i);
+
         solution.runways[best_runway_i].sequence[best_flight_i].get().position = best_flight_j;
         solution.runways[best_runway_i].sequence[best_flight_i].get().runway = best_runway_j;
         solution.runways[best_runway_i].prefix_penalty.pop_back();
@@ -1785,6 +1860,7 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
             solution.runways[best_runway_i].sequence[k].get().position = k;
         }
         solution.runways[best_runway_i].sequence.pop_back();
+        solution.hash ^= solution.runways[best_runway_j].removal_hash(best_flight_j);
         
         // Update prefix best_runway_i
         if (best_flight_i == 0) {
@@ -1834,6 +1910,7 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
         solution.runways[best_runway_i].penalty = solution.runways[best_runway_i].prefix_penalty.back();
         solution.runways[best_runway_j].penalty = solution.runways[best_runway_j].prefix_penalty.back();
         solution.objective -= delta;
+        assert(solution.test_hash());
         assert(solution.test_feasibility(m_instance));
         return true;
     }
@@ -1842,6 +1919,7 @@ bool ASP::first_improvement_inter_move(Solution &solution) {
 }
 
 bool ASP::first_improvement_intra_move(Solution &solution) {
+    OperatorScope scope(*this, Operator::FirstImprovementIntraMove, &solution);
     uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
@@ -1850,7 +1928,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
     uint32_t penalty = 0;         // Penalty of the new sequence after a swap
     uint32_t prev_start_time = 0; // Tracks the current time during penalty calculation
 
-    size_t start_runway = rand() % m_instance.get_num_runways();
+    size_t start_runway = random_index(m_instance.get_num_runways());
 
     for (size_t ri = 0; ri < m_instance.get_num_runways(); ++ri) {
         size_t runway_i = (start_runway + ri) % m_instance.get_num_runways();
@@ -1863,14 +1941,16 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
         std::vector<std::reference_wrapper<Flight>> &sequence =
             solution.runways[runway_i].sequence; // Original sequence of flights on the runway
 
-        size_t start_flight_i = rand() % sequence.size();
-        size_t start_flight_j = rand() % sequence.size();
+        size_t start_flight_i = random_index(sequence.size());
+        size_t start_flight_j = random_index(sequence.size());
 
         for (size_t fi = 0; fi < sequence.size(); fi++) {
             for (size_t fj = 0; fj < sequence.size(); fj++) {
                 size_t flight_i = (start_flight_i + fi) % sequence.size();
                 size_t flight_j = (start_flight_j + fj) % sequence.size();
 
+                if (flight_i != flight_j) scope.statistics.evaluated++;
+
                 if (flight_i < flight_j) {
                     penalty = solution.runways[runway_i].prefix_penalty[flight_i];
 
@@ -1905,6 +1985,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until fligth_j
                             penalty += solution.runways[runway_i].prefix_penalty[flight_j + 1] - solution.runways[runway_i].prefix_penalty[k];
                             prev_start_time = sequence[flight_j].get().start_time;
@@ -1918,8 +1999,10 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                     }
 
                     // Put fligth_i next to fligth_j
-                    if (penalty >= original_penalty) continue;
-                    else {
+                    if (penalty >= original_penalty) {
+                        scope.statistics.pruned++;
+                        continue;
+                    } else {
                         Flight &current_flight = sequence[flight_i].get();
                         Flight &prev_flight = sequence[flight_j].get();
 
@@ -1949,7 +2032,10 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
 
                     // [Flight_j + 2, Last]
                     for (size_t k = flight_j + 2; k < sequence.size(); k++) {
-                        if (penalty >= original_penalty) break;
+                        if (penalty >= original_penalty) {
+                            scope.statistics.pruned++;
+                            break;
+                        }
 
                         Flight &current_flight = sequence[k].get();
                         Flight &prev_flight = sequence[k - 1].get();
@@ -1962,6 +2048,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until end
                             penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -2037,6 +2124,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until fligth_i - 1
                             penalty += solution.runways[runway_i].prefix_penalty[flight_i] - solution.runways[runway_i].prefix_penalty[k];
                             prev_start_time = sequence[flight_i - 1].get().start_time;
@@ -2050,8 +2138,10 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                     }
 
                     // Connect fligth_i - 1 && fligth_i + 1 if possible
-                    if (penalty >= original_penalty) continue;
-                    else if (flight_i + 1 < sequence.size()){
+                    if (penalty >= original_penalty) {
+                        scope.statistics.pruned++;
+                        continue;
+                    } else if (flight_i + 1 < sequence.size()){
                         Flight &current_flight = sequence[flight_i + 1].get();
                         Flight &prev_flight = sequence[flight_i - 1].get();
 
@@ -2067,7 +2157,10 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
 
                     // [Flight_i + 2, Last]
                     for (size_t k = flight_i + 2; k < sequence.size(); k++) {
-                        if (penalty >= original_penalty) break;
+                        if (penalty >= original_penalty) {
+                            scope.statistics.pruned++;
+                            break;
+                        }
 
                         Flight &current_flight = sequence[k].get();
                         Flight &prev_flight = sequence[k - 1].get();
@@ -2080,6 +2173,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
                         
                         
                         if (current_flight.start_time == prev_start_time) {
+                            scope.statistics.shortcuts++;
                             // Nothing gonna change until last
                             penalty += solution.runways[runway_i].prefix_penalty[sequence.size()] - solution.runways[runway_i].prefix_penalty[k];
                             break;
@@ -2110,6 +2204,8 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
     if (delta > 0) {
         std::vector<std::reference_wrapper<Flight>> &sequence = solution.runways[best_runway_i].sequence;
 
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_i);
+
         if (best_flight_i < best_flight_j) {
             Flight &tmp = sequence[best_flight_i].get();
             
@@ -2132,6 +2228,8 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
             sequence[best_flight_j].get().position = best_flight_j; 
         }
 
+        solution.hash ^= solution.runways[best_runway_i].removal_hash(best_flight_j);
+
         sequence[0].get().start_time = sequence[0].get().get_release_time();
         prev_start_time = sequence[0].get().start_time;
         penalty = 0;
@@ -2154,6 +2252,7 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
 
         solution.runways[best_runway_i].penalty = penalty;
         solution.objective -= delta;
+        assert(solution.test_hash());
         assert(solution.test_feasibility(m_instance));
         return true;
     }
@@ -2161,3 +2260,145 @@ bool ASP::first_improvement_intra_move(Solution &solution) {
     return false;
 }
 
+void ASP::select_time_slots(const Solution &solution, const uint32_t anchor_time, std::vector<size_t> &runways,
+                            std::vector<size_t> &positions) const {
+    runways.clear();
+    positions.clear();
+
+    const size_t num_runways = solution.runways.size();
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        const std::vector<std::reference_wrapper<Flight>> &sequence = solution.runways[runway_i].sequence;
+
+        if (sequence.empty()) continue;
+
+        size_t position = static_cast<size_t>(
+            std::lower_bound(sequence.begin(), sequence.end(), anchor_time,
+                             [](const std::reference_wrapper<Flight> &flight, const uint32_t time) {
+                                 return flight.get().start_time < time;
+                             }) -
+            sequence.begin());
+
+        if (position == sequence.size() ||
+            (position > 0 && anchor_time - sequence[position - 1].get().start_time <
+                                 sequence[position].get().start_time - anchor_time)) {
+            position--;
+        }
+
+        const uint32_t start_time = sequence[position].get().start_time;
+        const uint32_t distance = start_time > anchor_time ? start_time - anchor_time : anchor_time - start_time;
+
+        if (distance > m_slot_window) continue;
+
+        runways.push_back(runway_i);
+        positions.push_back(position);
+    }
+}
+
+bool ASP::best_improvement_time_slot_assignment(Solution &solution) {
+    // Every anchor flight defines a time window around its start time. The flight closest to the anchor on each
+    // runway (if inside the window) occupies one slot, and the flights of the window are reassigned to the slots by
+    // solving a linear assignment problem. Only the flight at the slot changes on each runway, so the penalty of the
+    // runways is separable and the assignment is exact.
+    OperatorScope scope(*this, Operator::BestImprovementTimeSlotAssignment, &solution);
+    const size_t num_runways = m_instance.get_num_runways();
+
+    if (num_runways < 2) return false;
+
+    uint32_t delta = 0; // Delta := improvement in penalty (original penalty - new penalty)
+
+    for (size_t anchor_runway = 0; anchor_runway < num_runways; ++anchor_runway) {
+        const std::vector<std::reference_wrapper<Flight>> &anchor_sequence =
+            solution.runways[anchor_runway].sequence;
+
+        for (size_t anchor = 0; anchor < anchor_sequence.size(); ++anchor) {
+            const uint32_t anchor_time = anchor_sequence[anchor].get().start_time;
+
+            select_time_slots(solution, anchor_time, m_slot_runways, m_slot_positions);
+
+            const size_t num_slots = m_slot_runways.size();
+
+            if (num_slots < 2) continue;
+
+            // The flights of a time slot often select each other, so the same slots come back from the anchors of
+            // other runways. Only the first anchor of the scan selecting them solves their assignment.
+            bool solved = false;
+
+            for (size_t slot = 0; slot < num_slots and m_slot_runways[slot] < anchor_runway and not solved; ++slot) {
+                const Flight &flight = solution.runways[m_slot_runways[slot]].sequence[m_slot_positions[slot]].get();
+
+                select_time_slots(solution, flight.start_time, m_earlier_slot_runways, m_earlier_slot_positions);
+                solved = m_earlier_slot_runways == m_slot_runways and m_earlier_slot_positions == m_slot_positions;
+            }
+            if (solved) continue;
+
+            // cost[flight_slot][runway_slot] := penalty of the runway of runway_slot with the flight of flight_slot
+            m_slot_costs.resize(num_slots * num_slots);
+
+            uint32_t original_penalty = 0;
+
+            for (size_t runway_slot = 0; runway_slot < num_slots; ++runway_slot) {
+                const Runway &runway = solution.runways[m_slot_runways[runway_slot]];
+
+                original_penalty += runway.penalty;
+
+                for (size_t flight_slot = 0; flight_slot < num_slots; ++flight_slot) {
+                    uint32_t penalty = runway.penalty;
+
+                    if (flight_slot != runway_slot) {
+                        const Flight &flight =
+                            solution.runways[m_slot_runways[flight_slot]].sequence[m_slot_positions[flight_slot]].get();
+
+                        penalty = runway.replacement_penalty(m_instance, m_slot_positions[runway_slot], flight);
+                    }
+                    m_slot_costs[(flight_slot * num_slots) + runway_slot] = penalty;
+                }
+            }
+
+            scope.statistics.evaluated++; // One move per assignment
+            const uint64_t penalty = m_hungarian.solve(m_slot_costs, num_slots, m_slot_assignment);
+
+            if (penalty < original_penalty && original_penalty - penalty > delta) {
+                delta = original_penalty - static_cast<uint32_t>(penalty);
+                m_best_slot_runways = m_slot_runways;
+                m_best_slot_positions = m_slot_positions;
+                m_best_slot_assignment = m_slot_assignment;
+            }
+        }
+    }
+
+    // Apply the best assignment found
+    if (delta > 0) {
+        const size_t num_slots = m_best_slot_runways.size();
+
+        m_slot_flights.clear();
+        for (size_t slot = 0; slot < num_slots; ++slot) {
+            m_slot_flights.push_back(solution.runways[m_best_slot_runways[slot]].sequence[m_best_slot_positions[slot]]);
+        }
+
+        // The slots are on different runways, so their links do not overlap
+        for (size_t slot = 0; slot < num_slots; ++slot) {
+            solution.hash ^= solution.runways[m_best_slot_runways[slot]].neighbors_hash(m_best_slot_positions[slot]);
+        }
+
+        for (size_t flight_slot = 0; flight_slot < num_slots; ++flight_slot) {
+            const size_t runway_slot = m_best_slot_assignment[flight_slot];
+
+            solution.runways[m_best_slot_runways[runway_slot]].sequence[m_best_slot_positions[runway_slot]] =
+                m_slot_flights[flight_slot];
+        }
+
+        for (size_t slot = 0; slot < num_slots; ++slot) {
+            solution.hash ^= solution.runways[m_best_slot_runways[slot]].neighbors_hash(m_best_slot_positions[slot]);
+        }
+
+        for (size_t slot = 0; slot < num_slots; ++slot) {
+            solution.runways[m_best_slot_runways[slot]].update_schedule(m_instance, m_best_slot_positions[slot]);
+        }
+
+        solution.objective -= delta;
+        assert(solution.test_feasibility(m_instance));
+        return true;
+    }
+    return false;
+}
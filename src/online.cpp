@@ -0,0 +1,376 @@
+#include "online.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "ASP.hpp"
+#include "solution.hpp"
+
+namespace {
+
+constexpr size_t INSERTION_POSITIONS = 8; // Positions from the release time of a flight tried by its insertion
+
+constexpr size_t SLIP_PERCENTAGE = 10;  // Share of the stand-in arrivals followed by the slip of a flight received
+constexpr size_t CANCEL_PERCENTAGE = 3; // Share of the stand-in arrivals followed by the cancellation of one
+constexpr uint32_t MAX_SLIP = 30;       // Largest release time increase of a slip
+
+} // namespace
+
+std::vector<FlightEvent> stand_in_event_stream(const Instance &instance, const uint64_t seed) {
+    Xoshiro256 generator(seed);
+
+    std::vector<size_t> arrivals(instance.get_num_flights());
+    std::iota(arrivals.begin(), arrivals.end(), 0);
+    std::stable_sort(arrivals.begin(), arrivals.end(), [&](const size_t a, const size_t b) {
+        return instance.get_release_time(a) < instance.get_release_time(b);
+    });
+
+    std::vector<FlightEvent> events;
+    std::vector<size_t> received; // Flights inserted and not cancelled
+    std::vector<uint32_t> release_times(instance.get_num_flights());
+
+    for (const size_t flight : arrivals) {
+        release_times[flight] = instance.get_release_time(flight);
+        events.push_back({FlightEvent::Type::Insert, flight, release_times[flight]});
+        received.push_back(flight);
+
+        const uint64_t draw = generator.bounded(100);
+
+        if (draw < SLIP_PERCENTAGE) {
+            const size_t slipped = received[generator.bounded(received.size())];
+
+            release_times[slipped] += 1 + static_cast<uint32_t>(generator.bounded(MAX_SLIP));
+            events.push_back({FlightEvent::Type::Update, slipped, release_times[slipped]});
+        } else if (draw < SLIP_PERCENTAGE + CANCEL_PERCENTAGE and received.size() > instance.get_num_runways()) {
+            const size_t cancelled_i = generator.bounded(received.size());
+
+            events.push_back({FlightEvent::Type::Remove, received[cancelled_i], 0});
+            received[cancelled_i] = received.back();
+            received.pop_back();
+        }
+    }
+    return events;
+}
+
+OnlineASP::OnlineASP(const Instance &instance, const uint64_t seed)
+    : m_instance(instance), m_generator(seed), m_runways(instance.get_num_runways()),
+      m_start_times(instance.get_num_flights(), 0), m_runway_of(instance.get_num_flights(), 0),
+      m_scheduled(instance.get_num_flights(), false), m_block_begin(instance.get_num_runways()),
+      m_block_end(instance.get_num_runways()), m_window_instance(instance.window({}, {}, 0)),
+      m_window_asp(m_window_instance, m_generator()) {}
+
+uint32_t OnlineASP::delay_cost(const size_t flight) const {
+    return (m_start_times[flight] - m_instance.get_release_time(flight)) * m_instance.get_delay_penalty(flight);
+}
+
+size_t OnlineASP::first_position_after(const size_t runway_i, const uint32_t time) const {
+    const std::vector<size_t> &runway = m_runways[runway_i];
+
+    return static_cast<size_t>(
+        std::partition_point(runway.begin(), runway.end(),
+                             [&](const size_t flight) { return m_start_times[flight] < time; }) -
+        runway.begin());
+}
+
+void OnlineASP::reschedule(const size_t runway_i, const size_t position, const size_t changed_end) {
+    const std::vector<size_t> &runway = m_runways[runway_i];
+
+    for (size_t k = position; k < runway.size(); ++k) {
+        const size_t flight = runway[k];
+        uint32_t start_time = m_instance.get_release_time(flight);
+
+        if (k > 0) {
+            const size_t prev_flight = runway[k - 1];
+
+            start_time = std::max(start_time, m_start_times[prev_flight] +
+                                                  m_instance.get_runway_occupancy_time(prev_flight) +
+                                                  m_instance.get_separation_time(prev_flight, flight));
+        }
+        m_runway_of[flight] = runway_i;
+
+        // Nothing gonna change until end
+        if (k >= changed_end and start_time == m_start_times[flight]) break;
+
+        m_objective -= delay_cost(flight);
+        m_start_times[flight] = start_time;
+        m_objective += delay_cost(flight);
+    }
+}
+
+int64_t OnlineASP::insertion_delta(const size_t runway_i, const size_t position, const size_t flight) const {
+    const std::vector<size_t> &runway = m_runways[runway_i];
+
+    uint32_t start_time = m_instance.get_release_time(flight);
+
+    if (position > 0) {
+        const size_t prev_flight = runway[position - 1];
+
+        start_time = std::max(start_time, m_start_times[prev_flight] +
+                                              m_instance.get_runway_occupancy_time(prev_flight) +
+                                              m_instance.get_separation_time(prev_flight, flight));
+    }
+    int64_t delta = static_cast<int64_t>(start_time - m_instance.get_release_time(flight)) *
+                    m_instance.get_delay_penalty(flight);
+
+    // The following flights are pushed back until one of them keeps its start time
+    size_t prev_flight = flight;
+    uint32_t prev_start_time = start_time;
+
+    for (size_t k = position; k < runway.size(); ++k) {
+        const size_t current_flight = runway[k];
+
+        prev_start_time = std::max(m_instance.get_release_time(current_flight),
+                                   prev_start_time + m_instance.get_runway_occupancy_time(prev_flight) +
+                                       m_instance.get_separation_time(prev_flight, current_flight));
+
+        if (prev_start_time == m_start_times[current_flight]) break;
+
+        delta += static_cast<int64_t>(prev_start_time - m_start_times[current_flight]) *
+                 m_instance.get_delay_penalty(current_flight);
+        prev_flight = current_flight;
+    }
+    return delta;
+}
+
+void OnlineASP::cheapest_insertion(const size_t flight) {
+    int64_t best_delta = std::numeric_limits<int64_t>::max();
+    size_t best_runway_i = 0;
+    size_t best_position = 0;
+
+    for (size_t runway_i = 0; runway_i < m_runways.size(); ++runway_i) {
+        const size_t first = first_position_after(runway_i, m_instance.get_release_time(flight));
+        const size_t end_position = std::min(m_runways[runway_i].size(), first + INSERTION_POSITIONS);
+
+        for (size_t position = first > 0 ? first - 1 : 0; position <= end_position; ++position) {
+            const int64_t delta = insertion_delta(runway_i, position, flight);
+
+            if (delta < best_delta) {
+                best_delta = delta;
+                best_runway_i = runway_i;
+                best_position = position;
+            }
+        }
+    }
+
+    std::vector<size_t> &runway = m_runways[best_runway_i];
+    runway.insert(runway.begin() + static_cast<std::ptrdiff_t>(best_position), flight);
+
+    m_start_times[flight] = m_instance.get_release_time(flight); // No delay cost yet
+    m_scheduled[flight] = true;
+    reschedule(best_runway_i, best_position, best_position + 1);
+
+    assert(test_schedule());
+}
+
+void OnlineASP::unschedule(const size_t flight) {
+    const size_t runway_i = m_runway_of[flight];
+    std::vector<size_t> &runway = m_runways[runway_i];
+
+    const size_t position = first_position_after(runway_i, m_start_times[flight]);
+    assert(runway[position] == flight);
+
+    m_objective -= delay_cost(flight);
+    runway.erase(runway.begin() + static_cast<std::ptrdiff_t>(position));
+    m_scheduled[flight] = false;
+
+    reschedule(runway_i, position, position);
+
+    assert(test_schedule());
+}
+
+bool OnlineASP::repair_region(const uint32_t time) {
+    const size_t num_runways = m_runways.size();
+    const size_t half_block = std::max<size_t>(1, region_size / (2 * num_runways));
+
+    // Window: the flights of each runway around time, after the flight that precedes them as anchor
+    m_window_flights.clear();
+    m_anchor_start_times.clear();
+    m_anchor_runways.clear();
+    size_t region_cost = 0;
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        if (m_runways[runway_i].empty()) return false; // An empty runway breaks the perturbations
+
+        const size_t center = first_position_after(runway_i, time);
+
+        m_block_begin[runway_i] = center > half_block ? center - half_block : 0;
+        m_block_end[runway_i] = std::min(m_runways[runway_i].size(), center + half_block);
+        m_block_begin[runway_i] = std::min(m_block_begin[runway_i], m_block_end[runway_i] - 1);
+
+        for (size_t k = m_block_begin[runway_i]; k < m_block_end[runway_i]; ++k) {
+            m_window_flights.push_back(m_runways[runway_i][k]);
+            region_cost += delay_cost(m_runways[runway_i][k]);
+        }
+    }
+    const size_t num_region_flights = m_window_flights.size();
+
+    m_window_sequences.resize(num_runways);
+
+    for (size_t runway_i = 0, region_i = 0; runway_i < num_runways; ++runway_i) {
+        std::vector<size_t> &sequence = m_window_sequences[runway_i];
+        sequence.clear();
+
+        if (m_block_begin[runway_i] > 0) {
+            const size_t anchor = m_runways[runway_i][m_block_begin[runway_i] - 1];
+
+            sequence.push_back(num_region_flights + m_anchor_runways.size());
+            m_window_flights.push_back(anchor);
+            m_anchor_start_times.push_back(m_start_times[anchor]);
+            m_anchor_runways.push_back(runway_i);
+        }
+        for (size_t k = m_block_begin[runway_i]; k < m_block_end[runway_i]; ++k) {
+            sequence.push_back(region_i++);
+        }
+    }
+
+    const auto anchor_penalty = static_cast<uint32_t>(std::min<size_t>(region_cost + 1, Instance::MAX_ANCHOR_PENALTY));
+    m_window_instance = m_instance.window(m_window_flights, m_anchor_start_times, anchor_penalty);
+    m_window_asp.reload_instance();
+    m_window_asp.time_limit = time_limit;
+
+    m_window_asp.load_solution(m_window_solution, m_window_sequences, m_window_asp.flights);
+    assert(m_window_solution.objective == region_cost);
+
+    m_window_asp.improve(m_window_solution, max_ils_iterations);
+
+    if (m_window_solution.objective >= region_cost) return false;
+
+    m_window_solution.get_sequences(m_window_sequences);
+
+    // Runway behind each runway of the window: the runway of its anchor, or else one of the runways left
+    std::vector<size_t> runway_map(num_runways, num_runways);
+    std::vector<bool> runway_used(num_runways, false);
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        const std::vector<size_t> &sequence = m_window_sequences[runway_i];
+
+        if (not sequence.empty() and sequence.front() >= num_region_flights) {
+            runway_map[runway_i] = m_anchor_runways[sequence.front() - num_region_flights];
+            runway_used[runway_map[runway_i]] = true;
+        }
+    }
+    for (size_t runway_i = 0, runway = 0; runway_i < num_runways; ++runway_i) {
+        if (runway_map[runway_i] != num_runways) continue;
+
+        while (runway_used[runway]) {
+            runway++;
+        }
+        runway_map[runway_i] = runway;
+        runway_used[runway] = true;
+    }
+
+    // Splice the window back, and keep it only if the following flights do not lose the gain
+    m_saved_runways = m_runways;
+    m_saved_start_times = m_start_times;
+    m_saved_runway_of = m_runway_of;
+    const size_t original_objective = m_objective;
+
+    for (size_t runway = 0; runway < num_runways; ++runway) {
+        m_runways[runway].erase(m_runways[runway].begin() + static_cast<std::ptrdiff_t>(m_block_begin[runway]),
+                                m_runways[runway].begin() + static_cast<std::ptrdiff_t>(m_block_end[runway]));
+    }
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        const size_t runway = runway_map[runway_i];
+        std::vector<size_t> &sequence = m_runways[runway];
+        auto position = sequence.begin() + static_cast<std::ptrdiff_t>(m_block_begin[runway]);
+
+        for (const size_t window_flight : m_window_sequences[runway_i]) {
+            if (window_flight >= num_region_flights) continue; // Anchor, already in place
+
+            position = sequence.insert(position, m_window_flights[window_flight]) + 1;
+        }
+        m_block_end[runway] = static_cast<size_t>(position - sequence.begin());
+    }
+    for (size_t runway = 0; runway < num_runways; ++runway) {
+        reschedule(runway, m_block_begin[runway], m_block_end[runway] + 1);
+    }
+    assert(test_schedule());
+
+    if (m_objective < original_objective) return true;
+
+    std::swap(m_runways, m_saved_runways);
+    std::swap(m_start_times, m_saved_start_times);
+    std::swap(m_runway_of, m_saved_runway_of);
+    m_objective = original_objective;
+    return false;
+}
+
+void OnlineASP::insert(const size_t flight) {
+    if (m_scheduled[flight]) return;
+
+    cheapest_insertion(flight);
+    repair_region(m_instance.get_release_time(flight));
+}
+
+void OnlineASP::update(const size_t flight, const uint32_t release_time) {
+    if (not m_scheduled[flight]) {
+        m_instance.set_release_time(flight, release_time);
+        return;
+    }
+    unschedule(flight);
+    m_instance.set_release_time(flight, release_time);
+    cheapest_insertion(flight);
+    repair_region(release_time);
+}
+
+void OnlineASP::remove(const size_t flight) {
+    if (not m_scheduled[flight]) return;
+
+    const uint32_t start_time = m_start_times[flight];
+
+    unschedule(flight);
+    repair_region(start_time);
+}
+
+void OnlineASP::apply(const FlightEvent &event) {
+    switch (event.type) {
+    case FlightEvent::Type::Insert:
+        insert(event.flight);
+        break;
+    case FlightEvent::Type::Update:
+        update(event.flight, event.release_time);
+        break;
+    case FlightEvent::Type::Remove:
+        remove(event.flight);
+        break;
+    }
+}
+
+bool OnlineASP::test_schedule() const {
+    size_t objective = 0;
+
+    for (const std::vector<size_t> &runway : m_runways) {
+        uint32_t prev_start_time = 0;
+
+        for (size_t k = 0; k < runway.size(); ++k) {
+            const size_t flight = runway[k];
+            uint32_t start_time = m_instance.get_release_time(flight);
+
+            if (k > 0) {
+                start_time = std::max(start_time, prev_start_time +
+                                                      m_instance.get_runway_occupancy_time(runway[k - 1]) +
+                                                      m_instance.get_separation_time(runway[k - 1], flight));
+            }
+            if (not m_scheduled[flight] or start_time != m_start_times[flight]) return false;
+
+            objective += delay_cost(flight);
+            prev_start_time = start_time;
+        }
+    }
+    return objective == m_objective;
+}
+
+void OnlineASP::print_runway() const {
+    for (const std::vector<size_t> &runway : m_runways) {
+        for (const size_t flight : runway) {
+            std::cout << flight + 1 << ' ';
+        }
+        std::cout << "\n\n";
+    }
+}
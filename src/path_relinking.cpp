@@ -0,0 +1,341 @@
+#include "ASP.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr double ELITE_MIN_DISTANCE_RATIO = 0.05; // Minimum share of different flights to enter a non-improving pool
+constexpr size_t NUM_RELINK_CANDIDATES = 2;       // Best intermediate solutions of a path that get RVND
+
+} // namespace
+
+void ASP::compute_predecessors(EliteSolution &elite) const {
+    elite.predecessors.assign(m_instance.get_num_flights(), m_instance.get_num_flights());
+
+    for (const std::vector<size_t> &sequence : elite.sequences) {
+        for (size_t i = 1; i < sequence.size(); ++i) {
+            elite.predecessors[sequence[i]] = sequence[i - 1];
+        }
+    }
+}
+
+size_t ASP::elite_distance(const EliteSolution &a, const EliteSolution &b) const {
+    // Flights whose predecessor differs, which does not depend on the runways' labels
+    size_t distance = 0;
+
+    for (size_t flight = 0; flight < m_instance.get_num_flights(); ++flight) {
+        distance += a.predecessors[flight] != b.predecessors[flight] ? 1 : 0;
+    }
+    return distance;
+}
+
+bool ASP::add_to_elite_pool(const Solution &solution) {
+    if (elite_size == 0) return false;
+
+    m_elite_candidate.objective = solution.objective;
+    solution.get_sequences(m_elite_candidate.sequences);
+    compute_predecessors(m_elite_candidate);
+
+    const auto min_distance = std::max<size_t>(
+        1, static_cast<size_t>(ELITE_MIN_DISTANCE_RATIO * static_cast<double>(m_instance.get_num_flights())));
+
+    size_t best_objective = std::numeric_limits<size_t>::max();
+    size_t worst_i = 0;
+    size_t closest_distance = std::numeric_limits<size_t>::max();
+    size_t closest_worse_i = m_elite_pool.size(); // Most similar elite solution not better than the candidate
+    size_t closest_worse_distance = std::numeric_limits<size_t>::max();
+
+    for (size_t i = 0; i < m_elite_pool.size(); ++i) {
+        const EliteSolution &elite = m_elite_pool[i];
+        const size_t distance = elite_distance(elite, m_elite_candidate);
+
+        if (distance == 0) return false; // Already in the pool
+
+        best_objective = std::min(best_objective, elite.objective);
+        closest_distance = std::min(closest_distance, distance);
+
+        if (elite.objective > m_elite_pool[worst_i].objective) {
+            worst_i = i;
+        }
+        if (elite.objective >= m_elite_candidate.objective and distance < closest_worse_distance) {
+            closest_worse_distance = distance;
+            closest_worse_i = i;
+        }
+    }
+
+    // A new best always enters, otherwise the candidate must differ enough from every elite solution
+    const bool accepted = m_elite_candidate.objective < best_objective or closest_distance >= min_distance;
+
+    if (not accepted) return false;
+
+    if (m_elite_pool.size() < elite_size) {
+        m_elite_pool.push_back(m_elite_candidate);
+        return true;
+    }
+    if (m_elite_candidate.objective >= m_elite_pool[worst_i].objective) return false;
+
+    std::swap(m_elite_pool[closest_worse_i], m_elite_candidate);
+    return true;
+}
+
+bool ASP::path_relinking(Solution &solution, const EliteSolution &guide) { // NOLINT
+    const size_t num_flights = m_instance.get_num_flights();
+    const size_t num_runways = m_instance.get_num_runways();
+
+    const size_t original_objective = solution.objective;
+    solution.get_sequences(m_relink_origin);
+
+    // Runway and position of every flight in the guide
+    m_guide_runways.resize(num_flights);
+    m_guide_positions.resize(num_flights);
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        for (size_t i = 0; i < guide.sequences[runway_i].size(); ++i) {
+            m_guide_runways[guide.sequences[runway_i][i]] = runway_i;
+            m_guide_positions[guide.sequences[runway_i][i]] = i;
+        }
+    }
+
+    // Match the guide's runways to the solution's runways sharing the most flights (runways are interchangeable)
+    m_relink_costs.assign(num_runways * num_runways, 0);
+
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        for (size_t guide_i = 0; guide_i < num_runways; ++guide_i) {
+            m_relink_costs[(runway_i * num_runways) + guide_i] =
+                static_cast<uint32_t>(solution.runways[runway_i].sequence.size());
+        }
+        for (const auto &flight : solution.runways[runway_i].sequence) {
+            m_relink_costs[(runway_i * num_runways) + m_guide_runways[flight.get().get_id()]]--;
+        }
+    }
+    m_hungarian.solve(m_relink_costs, num_runways, m_relink_assignment);
+
+    m_relink_targets.resize(num_runways);
+    for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+        m_relink_targets[m_relink_assignment[runway_i]] = runway_i;
+    }
+
+    // Flights not yet in the runway matched with their guide runway
+    m_relink_pending.clear();
+    for (size_t flight = 0; flight < num_flights; ++flight) {
+        if (flights[flight].runway != m_relink_targets[m_guide_runways[flight]]) {
+            m_relink_pending.push_back(flight);
+        }
+    }
+
+    // Position in target_runway that follows the guide's order among the flights of the same guide runway
+    const auto guide_position = [&](const Runway &target_runway, const size_t flight) {
+        for (size_t position = 0; position < target_runway.sequence.size(); ++position) {
+            const size_t other = target_runway.sequence[position].get().get_id();
+
+            if (m_guide_runways[other] == m_guide_runways[flight] and
+                m_guide_positions[other] > m_guide_positions[flight]) {
+                return position;
+            }
+        }
+        return target_runway.sequence.size();
+    };
+
+    // Once the runways hold the flights of the guide, each one is put in the guide's order
+    const auto order_runways = [&]() {
+        m_relink_orders.resize(num_runways);
+        m_relink_fixed.assign(num_runways, 0);
+
+        for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+            std::vector<size_t> &order = m_relink_orders[runway_i];
+            order.clear();
+
+            for (const auto &flight : solution.runways[runway_i].sequence) {
+                order.push_back(flight.get().get_id());
+            }
+            std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+                if (m_guide_positions[a] != m_guide_positions[b]) return m_guide_positions[a] < m_guide_positions[b];
+                return m_guide_runways[a] < m_guide_runways[b];
+            });
+        }
+    };
+
+    // Skip the positions already in order, false once every runway is
+    const auto next_misplaced = [&]() {
+        bool misplaced = false;
+
+        for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+            const Runway &runway = solution.runways[runway_i];
+            size_t &fixed = m_relink_fixed[runway_i];
+
+            while (fixed < runway.sequence.size() and
+                   runway.sequence[fixed].get().get_id() == m_relink_orders[runway_i][fixed]) {
+                ++fixed;
+            }
+            misplaced = misplaced or fixed < runway.sequence.size();
+        }
+        return misplaced;
+    };
+
+    // Penalty of runway if the flight at position were moved back to target (nothing is modified)
+    const auto move_back_penalty = [&](const Runway &runway, const size_t target, const size_t position) {
+        uint32_t penalty = runway.prefix_penalty[target];
+        const Flight *prev_flight = target > 0 ? &runway.sequence[target - 1].get() : nullptr;
+        uint32_t prev_start_time = prev_flight != nullptr ? prev_flight->start_time : 0;
+
+        const auto schedule = [&](const Flight &flight) {
+            uint32_t start_time = flight.get_release_time();
+            if (prev_flight != nullptr) {
+                start_time = std::max(start_time, prev_start_time + prev_flight->get_runway_occupancy_time() +
+                                                      m_instance.get_separation_time(prev_flight->get_id(),
+                                                                                     flight.get_id()));
+            }
+            penalty += (start_time - flight.get_release_time()) * flight.get_delay_penalty();
+            prev_flight = &flight;
+            prev_start_time = start_time;
+        };
+
+        schedule(runway.sequence[position].get());
+        for (size_t i = target; i < runway.sequence.size(); ++i) {
+            if (i != position) schedule(runway.sequence[i].get());
+        }
+        return penalty;
+    };
+
+    std::array<size_t, NUM_RELINK_CANDIDATES> candidate_objectives{};
+    candidate_objectives.fill(std::numeric_limits<size_t>::max());
+    m_relink_candidates.resize(NUM_RELINK_CANDIDATES);
+
+    // Walk toward the guide, each step applies the cheapest pending move: first the flights that change runway, then
+    // the flights that change position within their runway
+    bool ordering = false;
+
+    while (true) {
+        if (not ordering) {
+            int64_t best_delta = std::numeric_limits<int64_t>::max();
+            size_t best_pending_i = m_relink_pending.size();
+            size_t best_position = 0;
+
+            for (size_t pending_i = 0; pending_i < m_relink_pending.size(); ++pending_i) {
+                const Flight &flight = flights[m_relink_pending[pending_i]];
+                const Runway &source_runway = solution.runways[flight.runway];
+                const Runway &target_runway = solution.runways[m_relink_targets[m_guide_runways[flight.get_id()]]];
+
+                if (source_runway.sequence.size() == 1) continue; // Prevents a runway to be empty
+
+                const size_t position = guide_position(target_runway, flight.get_id());
+                const int64_t delta =
+                    static_cast<int64_t>(source_runway.removal_penalty(m_instance, flight.position)) -
+                    source_runway.penalty +
+                    static_cast<int64_t>(target_runway.insertion_penalty(m_instance, position, flight)) -
+                    target_runway.penalty;
+
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_pending_i = pending_i;
+                    best_position = position;
+                }
+            }
+
+            const bool moved = best_pending_i < m_relink_pending.size();
+
+            if (moved) {
+                Flight &flight = flights[m_relink_pending[best_pending_i]];
+                Runway &source_runway = solution.runways[flight.runway];
+                Runway &target_runway = solution.runways[m_relink_targets[m_guide_runways[flight.get_id()]]];
+                const size_t source_position = flight.position;
+
+                source_runway.sequence.erase(source_runway.sequence.begin() +
+                                             static_cast<std::ptrdiff_t>(source_position));
+                source_runway.update_schedule(m_instance, source_position);
+
+                target_runway.sequence.insert(
+                    target_runway.sequence.begin() + static_cast<std::ptrdiff_t>(best_position), flight);
+                target_runway.update_schedule(m_instance, best_position);
+
+                solution.objective = static_cast<size_t>(static_cast<int64_t>(solution.objective) + best_delta);
+                assert(solution.test_feasibility(m_instance));
+
+                m_relink_pending[best_pending_i] = m_relink_pending.back();
+                m_relink_pending.pop_back();
+            }
+
+            // Every flight is on its guide runway, or the remaining ones are alone in their runway
+            if (m_relink_pending.empty() or not moved) {
+                ordering = true;
+                order_runways();
+                if (not next_misplaced()) break; // The end of the path is the guide
+            }
+            if (not moved) continue;
+        } else {
+            int64_t best_delta = std::numeric_limits<int64_t>::max();
+            size_t best_runway_i = num_runways;
+
+            // On each runway, the flight due at the first misplaced position is moved back there
+            for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+                const Runway &runway = solution.runways[runway_i];
+                const size_t target = m_relink_fixed[runway_i];
+                if (target == runway.sequence.size()) continue;
+
+                const size_t position = flights[m_relink_orders[runway_i][target]].position;
+                const int64_t delta =
+                    static_cast<int64_t>(move_back_penalty(runway, target, position)) - runway.penalty;
+
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_runway_i = runway_i;
+                }
+            }
+
+            Runway &runway = solution.runways[best_runway_i];
+            const size_t target = m_relink_fixed[best_runway_i];
+            const size_t position = flights[m_relink_orders[best_runway_i][target]].position;
+
+            std::rotate(runway.sequence.begin() + static_cast<std::ptrdiff_t>(target),
+                        runway.sequence.begin() + static_cast<std::ptrdiff_t>(position),
+                        runway.sequence.begin() + static_cast<std::ptrdiff_t>(position) + 1);
+            runway.update_schedule(m_instance, target);
+
+            solution.objective = static_cast<size_t>(static_cast<int64_t>(solution.objective) + best_delta);
+            assert(solution.test_feasibility(m_instance));
+
+            if (not next_misplaced()) break; // The end of the path is the guide
+        }
+
+        // Keep the best intermediate solutions
+        const auto worst_candidate = static_cast<size_t>(
+            std::max_element(candidate_objectives.begin(), candidate_objectives.end()) - candidate_objectives.begin());
+
+        if (solution.objective < candidate_objectives[worst_candidate]) {
+            candidate_objectives[worst_candidate] = solution.objective;
+            solution.get_sequences(m_relink_candidates[worst_candidate]);
+        }
+    }
+
+    // Local search on the best intermediate solutions
+    Solution candidate;
+    size_t best_objective = original_objective;
+    size_t best_candidate = NUM_RELINK_CANDIDATES;
+
+    for (size_t candidate_i = 0; candidate_i < NUM_RELINK_CANDIDATES; ++candidate_i) {
+        if (candidate_objectives[candidate_i] == std::numeric_limits<size_t>::max()) continue;
+
+        load_solution(candidate, m_relink_candidates[candidate_i], flights_perturbation);
+        RVND(candidate);
+
+        if (candidate.objective < best_objective) {
+            best_objective = candidate.objective;
+            best_candidate = candidate_i;
+            candidate.get_sequences(m_relink_candidates[candidate_i]);
+        }
+    }
+
+    if (best_candidate == NUM_RELINK_CANDIDATES) {
+        load_solution(solution, m_relink_origin, flights);
+        return false;
+    }
+    load_solution(solution, m_relink_candidates[best_candidate], flights);
+    return true;
+}
@@ -14,7 +14,7 @@ void ASP::P4(Solution &solution) { // NOLINT
     std::vector<Perturbation> perturbations{Perturbation::IntraSwap, Perturbation::InterSwap, /* Perturbation::IntraMove, */
                                             Perturbation::InterMove};
 
-    size_t current_perturbation = rand() % perturbations.size();
+    size_t current_perturbation = random_index(perturbations.size());
 
     switch (perturbations[current_perturbation]) {
     case Perturbation::IntraSwap:
@@ -30,11 +30,13 @@ void ASP::P4(Solution &solution) { // NOLINT
         inter_move(solution);
         break;
     }
+    solution.update_hash(); // The perturbations do not maintain it
 
     assert(solution.test_feasibility(m_instance));
 }
 
 void ASP::random_inter_block_swap(Solution &solution) {
+    OperatorScope scope(*this, Operator::RandomInterBlockSwap, &solution);
     if (solution.runways.size() < 2) {
         return;
     }
@@ -83,9 +85,24 @@ void ASP::random_inter_block_swap(Solution &solution) {
     Flight &flight_i = runway_i.sequence[flight_i_pos].get();
     Flight &flight_j = runway_j.sequence[flight_j_pos].get();
 
+    // Only the links into and out of the blocks change
+    const auto blocks_hash = [&]() {
+        uint64_t hash = runway_i.link_hash(flight_i_pos) ^ runway_j.link_hash(flight_j_pos);
+
+        if (flight_i_pos + block_i_size < runway_i.sequence.size()) {
+            hash ^= runway_i.link_hash(flight_i_pos + block_i_size);
+        }
+        if (flight_j_pos + block_i_size < runway_j.sequence.size()) {
+            hash ^= runway_j.link_hash(flight_j_pos + block_i_size);
+        }
+        return hash;
+    };
+
+    solution.hash ^= blocks_hash();
     for (size_t k = 0; k < block_i_size; ++k) {
         std::swap(runway_i.sequence[flight_i_pos + k], runway_j.sequence[flight_j_pos + k]);
     }
+    solution.hash ^= blocks_hash();
 
     if (flight_i_pos == 0) {
         Flight &current_flight = runway_i.sequence[0].get();
@@ -303,19 +320,20 @@ bool ASP::best_improvement_free_space(Solution &solution) {
 }
 
 void ASP::intra_swap(Solution &solution) {
+    OperatorScope scope(*this, Operator::IntraSwap, &solution);
     size_t best_runway_i = 0;
 
     do {
-        best_runway_i = rand() % solution.runways.size();
+        best_runway_i = random_index(solution.runways.size());
     } while (solution.runways[best_runway_i].sequence.size() < 2);
 
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
 
-    best_flight_i = rand() % solution.runways[best_runway_i].sequence.size();
+    best_flight_i = random_index(solution.runways[best_runway_i].sequence.size());
 
     do {
-        best_flight_j = rand() % solution.runways[best_runway_i].sequence.size();
+        best_flight_j = random_index(solution.runways[best_runway_i].sequence.size());
     } while (best_flight_i == best_flight_j);
 
     if (best_flight_i > best_flight_j) {
@@ -365,22 +383,23 @@ void ASP::intra_swap(Solution &solution) {
 }
 
 void ASP::inter_swap(Solution &solution) {
+    OperatorScope scope(*this, Operator::InterSwap, &solution);
     size_t best_runway_i = 0;
     size_t best_runway_j = 0;
 
-    best_runway_i = rand() % solution.runways.size();
+    best_runway_i = random_index(solution.runways.size());
 
     do {
-        best_runway_j = rand() % solution.runways.size();
+        best_runway_j = random_index(solution.runways.size());
     } while (best_runway_i == best_runway_j);
 
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
 
-    best_flight_i = rand() % solution.runways[best_runway_i].sequence.size();
+    best_flight_i = random_index(solution.runways[best_runway_i].sequence.size());
 
     do {
-        best_flight_j = rand() % solution.runways[best_runway_j].sequence.size();
+        best_flight_j = random_index(solution.runways[best_runway_j].sequence.size());
     } while (best_flight_i == best_flight_j);
 
     uint32_t original_penalty_i = solution.runways[best_runway_i].penalty;
@@ -462,22 +481,23 @@ void ASP::intra_move(Solution &solution) {
 }
 
 void ASP::inter_move(Solution &solution) {
+    OperatorScope scope(*this, Operator::InterMove, &solution);
     size_t best_runway_i = 0;
     size_t best_runway_j = 0;
 
     do {
-        best_runway_i = rand() % solution.runways.size();
+        best_runway_i = random_index(solution.runways.size());
     } while (solution.runways[best_runway_i].sequence.size() < 2);
 
     do {
-        best_runway_j = rand() % solution.runways.size();
+        best_runway_j = random_index(solution.runways.size());
     } while (best_runway_i == best_runway_j);
 
     size_t best_flight_i = 0;
     size_t best_flight_j = 0;
 
-    best_flight_i = rand() % solution.runways[best_runway_i].sequence.size();
-    best_flight_j = rand() % (solution.runways[best_runway_j].sequence.size() + 1);
+    best_flight_i = random_index(solution.runways[best_runway_i].sequence.size());
+    best_flight_j = random_index(solution.runways[best_runway_j].sequence.size() + 1);
 
     uint32_t original_penalty_i = solution.runways[best_runway_i].penalty;
     uint32_t original_penalty_j = solution.runways[best_runway_j].penalty;
@@ -570,6 +590,7 @@ void ASP::inter_move(Solution &solution) {
 }
 
 void ASP::chain(Solution &solution) {
+    OperatorScope scope(*this, Operator::Chain, &solution);
     for (size_t i = 0; i < m_instance.get_num_runways(); ++i){
         size_t best_runway_i = i;
         size_t best_runway_j = (i + 1) % m_instance.get_num_runways();
@@ -577,8 +598,8 @@ void ASP::chain(Solution &solution) {
         size_t best_flight_i = 0;
         size_t best_flight_j = 0;
 
-        best_flight_i = rand() % solution.runways[best_runway_i].sequence.size();
-        best_flight_j = rand() % (solution.runways[best_runway_j].sequence.size() + 1);
+        best_flight_i = random_index(solution.runways[best_runway_i].sequence.size());
+        best_flight_j = random_index(solution.runways[best_runway_j].sequence.size() + 1);
 
         uint32_t original_penalty_i = solution.runways[best_runway_i].penalty;
         uint32_t original_penalty_j = solution.runways[best_runway_j].penalty;
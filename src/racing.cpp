@@ -0,0 +1,169 @@
+#include "ASP.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <omp.h>
+#include <vector>
+
+namespace {
+
+// A GRASP start raced by successive halving, kept as flight ids between rounds
+struct RacingStart {
+    std::vector<std::vector<size_t>> sequences;
+    size_t objective = std::numeric_limits<size_t>::max();
+    size_t initial_objective = 0; // After the construction and the first RVND
+    size_t ils_iteration = 1;     // Resumes the perturbation strength of the ILS in the next round
+    size_t ils_iterations = 0;    // ILS iterations spent on the start
+    size_t last_gain = 0;         // Improvement during the last round
+    Xoshiro256 generator;         // Own generator, so a start does not depend on the thread that runs it
+};
+
+} // namespace
+
+Solution ASP::racing_GILS_RVND(const size_t max_iterations, const size_t max_ils_iterations, // NOLINT
+                               const size_t reduction_factor) {
+    const size_t num_starts = std::max<size_t>(1, max_iterations);
+    const size_t eta = std::max<size_t>(2, reduction_factor);
+
+    // Rounds until one start is left, the budget per start grows by eta each round so that every round costs
+    // about the same and the last start gets the full ILS
+    size_t num_rounds = 1;
+    for (size_t alive = num_starts; alive > 1; alive = (alive + eta - 1) / eta) {
+        num_rounds++;
+    }
+    size_t budget = max_ils_iterations;
+    for (size_t round = 1; round < num_rounds and budget > 1; ++round) {
+        budget /= eta;
+    }
+
+    std::cout << ">> Racing GILS-RVND (" << num_starts << " starts, " << num_rounds << " rounds, "
+              << omp_get_max_threads() << " threads)\n";
+
+    start_clock();
+
+    std::vector<RacingStart> starts(num_starts);
+    for (RacingStart &start : starts) {
+        start.generator.seed(m_generator());
+    }
+
+    std::vector<size_t> alive(num_starts);
+    std::iota(alive.begin(), alive.end(), 0);
+
+    size_t round = 1;
+    bool finished = false;
+
+#pragma omp parallel
+    {
+        // Each worker owns its flights, scratch buffers and visited optima, only the instance is shared
+        ASP worker = *this;
+        Solution local_best;
+
+#pragma omp barrier
+
+#pragma omp for schedule(static)
+        for (size_t start_i = 0; start_i < num_starts; ++start_i) {
+            RacingStart &start = starts[start_i];
+            std::swap(worker.m_generator, start.generator);
+
+            local_best = worker.construct(worker.flights);
+            worker.RVND(local_best);
+
+            std::swap(worker.m_generator, start.generator);
+
+            local_best.get_sequences(start.sequences);
+            start.objective = local_best.objective;
+            start.initial_objective = local_best.objective;
+
+#pragma omp critical(racing_best)
+            update_time_to_best(local_best.objective);
+        }
+
+        while (not finished) {
+            // The last start runs until max_ils_iterations without improvement
+            const size_t round_budget = alive.size() == 1 ? std::numeric_limits<size_t>::max() : budget;
+
+#pragma omp for schedule(static)
+            for (size_t alive_i = 0; alive_i < alive.size(); ++alive_i) {
+                RacingStart &start = starts[alive[alive_i]];
+                start.last_gain = 0;
+
+                if (start.ils_iteration > max_ils_iterations) continue; // Converged, its objective is final
+
+                worker.load_solution(local_best, start.sequences, worker.flights);
+                std::swap(worker.m_generator, start.generator);
+
+                const uint64_t local_searches = worker.m_local_searches; // One RVND per ILS iteration
+                start.ils_iteration =
+                    worker.ILS_RVND(local_best, max_ils_iterations, round_budget, start.ils_iteration);
+                start.ils_iterations += worker.m_local_searches - local_searches;
+
+                std::swap(worker.m_generator, start.generator);
+
+                if (local_best.objective < start.objective) {
+                    start.last_gain = start.objective - local_best.objective;
+                    start.objective = local_best.objective;
+                    local_best.get_sequences(start.sequences);
+
+#pragma omp critical(racing_best)
+                    update_time_to_best(local_best.objective);
+                }
+            }
+
+#pragma omp single
+            {
+                // Successive halving: the best 1/eta starts go on, ties favor the ones still improving
+                std::sort(alive.begin(), alive.end(), [&](const size_t a, const size_t b) {
+                    if (starts[a].objective != starts[b].objective) return starts[a].objective < starts[b].objective;
+                    if (starts[a].last_gain != starts[b].last_gain) return starts[a].last_gain > starts[b].last_gain;
+                    return a < b;
+                });
+
+                double mean = 0;
+                for (const size_t start_i : alive) {
+                    mean += static_cast<double>(starts[start_i].objective);
+                }
+                mean /= static_cast<double>(alive.size());
+
+                double variance = 0;
+                for (const size_t start_i : alive) {
+                    const double deviation = static_cast<double>(starts[start_i].objective) - mean;
+                    variance += deviation * deviation;
+                }
+                variance /= static_cast<double>(alive.size());
+
+                std::cout << "[" << round << "/" << num_rounds << "]\t" << alive.size() << " starts, budget "
+                          << (alive.size() == 1 ? max_ils_iterations : budget) << "\tBest: "
+                          << starts[alive.front()].objective << "\tMean: " << mean
+                          << "\tStd dev: " << std::sqrt(variance) << '\n';
+
+                if (alive.size() == 1 or time_expired()) {
+                    finished = true;
+                } else {
+                    alive.resize((alive.size() + eta - 1) / eta);
+                    budget *= eta;
+                    round++;
+                }
+            }
+        }
+
+#pragma omp critical(racing_best)
+        merge_statistics(worker);
+    }
+
+    const RacingStart &winner = starts[alive.front()];
+
+    std::cout << "\nWinner: start " << alive.front() + 1 << " (" << winner.initial_objective << " -> "
+              << winner.objective << " in " << winner.ils_iterations << " ILS iterations)\n";
+
+    Solution best_found;
+    load_solution(best_found, winner.sequences, flights);
+
+    std::cout << "Best found: " << best_found.objective << '\n';
+    return best_found;
+}
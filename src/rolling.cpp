@@ -0,0 +1,318 @@
+#include "ASP.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr size_t BOUNDARY_POSITIONS = 8;   // Positions from the release time of a flight tried by the boundary search
+constexpr size_t MAX_BOUNDARY_PASSES = 10; // Passes of the boundary search over its flights
+
+} // namespace
+
+bool ASP::boundary_local_search(Solution &solution, const std::vector<size_t> &flight_ids) {
+    bool improved = false;
+    bool improving = true;
+
+    for (size_t pass = 0; pass < MAX_BOUNDARY_PASSES and improving; ++pass) {
+        improving = false;
+
+        for (const size_t flight_id : flight_ids) {
+            Flight &flight = flights[flight_id];
+            const size_t source_runway_i = flight.runway;
+            const size_t source_position = flight.position;
+            Runway &source_runway = solution.runways[source_runway_i];
+
+            if (source_runway.sequence.size() == 1) continue; // Prevents a runway to be empty
+
+            const uint32_t original_penalty = source_runway.penalty;
+
+            source_runway.sequence.erase(source_runway.sequence.begin() +
+                                         static_cast<std::ptrdiff_t>(source_position));
+            source_runway.update_schedule(m_instance, source_position);
+
+            // Putting the flight back where it was restores original_penalty
+            const int64_t original_delta = static_cast<int64_t>(original_penalty) - source_runway.penalty;
+            int64_t best_delta = original_delta;
+            size_t best_runway_i = source_runway_i;
+            size_t best_position = source_position;
+
+            for (size_t runway_i = 0; runway_i < solution.runways.size(); ++runway_i) {
+                const Runway &runway = solution.runways[runway_i];
+
+                // Start times grow along a runway: look around the first flight that starts after the release time
+                const auto first = static_cast<size_t>(
+                    std::partition_point(runway.sequence.begin(), runway.sequence.end(),
+                                         [&](const auto &other) {
+                                             return other.get().start_time < flight.get_release_time();
+                                         }) -
+                    runway.sequence.begin());
+                const size_t end_position = std::min(runway.sequence.size(), first + BOUNDARY_POSITIONS);
+
+                for (size_t position = first > 0 ? first - 1 : 0; position <= end_position; ++position) {
+                    const int64_t delta =
+                        static_cast<int64_t>(runway.insertion_penalty(m_instance, position, flight)) - runway.penalty;
+
+                    if (delta < best_delta) {
+                        best_delta = delta;
+                        best_runway_i = runway_i;
+                        best_position = position;
+                    }
+                }
+            }
+
+            Runway &target_runway = solution.runways[best_runway_i];
+            target_runway.sequence.insert(target_runway.sequence.begin() + static_cast<std::ptrdiff_t>(best_position),
+                                          flight);
+            target_runway.update_schedule(m_instance, best_position);
+
+            improving = improving or best_delta < original_delta;
+        }
+        improved = improved or improving;
+    }
+
+    solution.objective = 0;
+    for (const Runway &runway : solution.runways) {
+        solution.objective += runway.penalty;
+    }
+    solution.update_hash();
+    assert(solution.test_feasibility(m_instance));
+
+    return improved;
+}
+
+Solution ASP::rolling_horizon(const size_t max_ils_iterations, size_t window_size, // NOLINT
+                              const size_t window_overlap) {
+    const size_t num_flights = m_instance.get_num_flights();
+    const size_t num_runways = m_instance.get_num_runways();
+
+    window_size = std::max(window_size, 2 * num_runways);
+    const size_t overlap = std::min(window_overlap, window_size - 1);
+    const size_t step = window_size - overlap; // Flights of a window that may be committed
+
+    std::cout << ">> Rolling horizon (windows of " << window_size << " flights, overlap " << overlap << ")\n";
+
+    start_clock();
+
+    // Flights not committed yet, by release time
+    std::vector<size_t> pending(num_flights);
+    std::iota(pending.begin(), pending.end(), 0);
+    std::stable_sort(pending.begin(), pending.end(), [&](const size_t a, const size_t b) {
+        return m_instance.get_release_time(a) < m_instance.get_release_time(b);
+    });
+
+    // Committed schedule, whose last flight on each runway is frozen at committed_start_times
+    std::vector<std::vector<size_t>> committed(num_runways);
+    std::vector<uint32_t> committed_start_times(num_runways, 0);
+    std::vector<bool> is_committed(num_flights, false);
+
+    std::vector<size_t> boundary_flights; // Flights around the cut of each window, for the final search
+    std::vector<size_t> window_flights;   // Flight of the whole instance behind each flight of the window
+    std::vector<size_t> anchor_runways;   // Runway of the whole solution behind each anchor of the window
+    std::vector<uint32_t> anchor_start_times;
+    std::vector<std::vector<size_t>> sequences(num_runways);
+    std::vector<size_t> runway_map(num_runways);
+    std::vector<bool> runway_used(num_runways);
+
+    size_t window_i = 0;
+
+    while (not pending.empty()) {
+        const size_t num_window_flights = std::min(window_size, pending.size());
+        const bool last_window = num_window_flights == pending.size();
+
+        window_flights.assign(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(num_window_flights));
+        anchor_runways.clear();
+        anchor_start_times.clear();
+
+        // Anchors: the last committed flight of each runway, after the flights of the window
+        for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+            if (not committed[runway_i].empty()) {
+                window_flights.push_back(committed[runway_i].back());
+                anchor_runways.push_back(runway_i);
+                anchor_start_times.push_back(committed_start_times[runway_i]);
+            }
+        }
+
+        // Initial solution: every anchor starts a runway, then each flight by release time goes at the end of the
+        // runway where it starts first
+        std::vector<uint32_t> last_start_times(num_runways, 0);
+        uint64_t initial_penalty = 0;
+
+        for (std::vector<size_t> &sequence : sequences) {
+            sequence.clear();
+        }
+        for (size_t anchor_i = 0; anchor_i < anchor_runways.size(); ++anchor_i) {
+            sequences[anchor_i].push_back(num_window_flights + anchor_i);
+            last_start_times[anchor_i] = anchor_start_times[anchor_i];
+        }
+        for (size_t window_flight = 0; window_flight < num_window_flights; ++window_flight) {
+            const size_t flight = window_flights[window_flight];
+            const uint32_t release_time = m_instance.get_release_time(flight);
+
+            uint32_t best_start_time = std::numeric_limits<uint32_t>::max();
+            size_t best_runway_i = 0;
+
+            for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+                uint32_t start_time = release_time;
+
+                if (not sequences[runway_i].empty()) {
+                    const size_t prev_flight = window_flights[sequences[runway_i].back()];
+
+                    start_time = std::max(release_time, last_start_times[runway_i] +
+                                                            m_instance.get_runway_occupancy_time(prev_flight) +
+                                                            m_instance.get_separation_time(prev_flight, flight));
+                }
+                // Ties go to an empty runway, so that every runway gets a flight
+                if (start_time < best_start_time or
+                    (start_time == best_start_time and sequences[runway_i].empty())) {
+                    best_start_time = start_time;
+                    best_runway_i = runway_i;
+                }
+            }
+            sequences[best_runway_i].push_back(window_flight);
+            last_start_times[best_runway_i] = best_start_time;
+            initial_penalty += static_cast<uint64_t>(best_start_time - release_time) *
+                               m_instance.get_delay_penalty(flight);
+        }
+
+        // Window instance. Anchors are released at their committed start times, nothing can precede them without
+        // delaying them, and a delayed anchor costs more than the whole initial solution.
+        const auto anchor_penalty =
+            static_cast<uint32_t>(std::min<uint64_t>(initial_penalty + 1, Instance::MAX_ANCHOR_PENALTY));
+        const Instance window_instance = m_instance.window(window_flights, anchor_start_times, anchor_penalty);
+
+        ASP window(window_instance, m_generator());
+        window.neighborhood_selection = neighborhood_selection;
+        window.parallel_neighborhoods = parallel_neighborhoods;
+        window.multi_move = multi_move;
+        window.acceptance = acceptance;
+        window.acceptance_ratio = acceptance_ratio;
+        window.late_acceptance_length = late_acceptance_length;
+
+        if (time_limit > 0) {
+            // Even share of the remaining time among the remaining windows
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+            const size_t remaining_windows = 1 + ((pending.size() - num_window_flights + step - 1) / step);
+
+            window.time_limit = std::max(1e-3, (time_limit - elapsed) / static_cast<double>(remaining_windows));
+        }
+
+        // Same local search as GILS-RVND, from the initial solution
+        Solution local_best;
+        window.load_solution(local_best, sequences, window.flights);
+        assert(local_best.objective == initial_penalty);
+
+        window.improve(local_best, max_ils_iterations);
+        merge_statistics(window);
+
+        // Past Instance::MAX_ANCHOR_PENALTY, a delayed anchor may cost less than the initial solution, so the local
+        // search may have moved one. The committed schedule can not change, the window then keeps its initial solution.
+        bool anchor_moved = false;
+        for (const Runway &runway : local_best.runways) {
+            for (size_t position = 1; position < runway.sequence.size(); ++position) {
+                anchor_moved = anchor_moved or runway.sequence[position].get().get_id() >= num_window_flights;
+            }
+        }
+        if (anchor_moved) {
+            window.load_solution(local_best, sequences, window.flights);
+        }
+
+        // Runway of the whole solution behind each runway of the window, found through the anchors
+        std::fill(runway_used.begin(), runway_used.end(), false);
+        std::fill(runway_map.begin(), runway_map.end(), num_runways);
+
+        for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+            const auto &sequence = local_best.runways[runway_i].sequence;
+
+            if (not sequence.empty() and sequence.front().get().get_id() >= num_window_flights) {
+                const size_t runway = anchor_runways[sequence.front().get().get_id() - num_window_flights];
+
+                if (not runway_used[runway]) {
+                    runway_map[runway_i] = runway;
+                    runway_used[runway] = true;
+                }
+            }
+        }
+        for (size_t runway_i = 0, runway = 0; runway_i < num_runways; ++runway_i) {
+            if (runway_map[runway_i] != num_runways) continue;
+
+            while (runway_used[runway]) {
+                runway++;
+            }
+            runway_map[runway_i] = runway;
+            runway_used[runway] = true;
+        }
+
+        // Commit, on each runway, the flights that start before the release time of the first flight after the
+        // step (everything in the last window, or if no flight starts that early)
+        const auto commit = [&](const uint32_t cut) {
+            size_t num_committed = 0;
+
+            for (size_t runway_i = 0; runway_i < num_runways; ++runway_i) {
+                const size_t runway = runway_map[runway_i];
+
+                for (const auto &flight_ref : local_best.runways[runway_i].sequence) {
+                    const Flight &flight = flight_ref.get();
+
+                    if (flight.get_id() >= num_window_flights) continue; // Anchor, already committed
+                    if (flight.start_time >= cut) break;
+
+                    const size_t flight_id = window_flights[flight.get_id()];
+
+                    committed[runway].push_back(flight_id);
+                    committed_start_times[runway] = flight.start_time;
+                    is_committed[flight_id] = true;
+                    num_committed++;
+                }
+            }
+            return num_committed;
+        };
+
+        size_t num_committed = 0;
+        if (not last_window) {
+            num_committed = commit(m_instance.get_release_time(window_flights[step]));
+
+            const size_t half_overlap = std::max<size_t>(1, overlap / 2);
+            for (size_t i = step > half_overlap ? step - half_overlap : 0;
+                 i < std::min(num_window_flights, step + half_overlap); ++i) {
+                boundary_flights.push_back(window_flights[i]);
+            }
+        }
+        if (num_committed == 0) {
+            num_committed = commit(std::numeric_limits<uint32_t>::max());
+        }
+
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [&](const size_t flight) { return is_committed[flight]; }),
+                      pending.end());
+
+        std::cout << "[" << ++window_i << "]\t" << num_window_flights << " flights\tInitial: " << initial_penalty
+                  << "\tLocal best: " << local_best.objective << "\tCommitted: " << num_committed << '\n';
+    }
+
+    // Stitch the committed runways, then search the flights around the cuts between windows
+    Solution best_found;
+    load_solution(best_found, committed, flights);
+
+    std::cout << "\nStitched solution: " << best_found.objective << '\n';
+
+    std::sort(boundary_flights.begin(), boundary_flights.end());
+    boundary_flights.erase(std::unique(boundary_flights.begin(), boundary_flights.end()), boundary_flights.end());
+
+    if (not time_expired() and boundary_local_search(best_found, boundary_flights)) {
+        std::cout << "Boundary search: " << best_found.objective << " (" << boundary_flights.size()
+                  << " boundary flights)\n";
+    }
+    update_time_to_best(best_found.objective);
+
+    std::cout << "\nBest found: " << best_found.objective << '\n';
+    return best_found;
+}
@@ -37,6 +37,112 @@ uint32_t Runway::calculate_total_penalty(const Instance &instance) const {
 
 void Runway::update_total_penalty(const Instance &instance) { penalty = calculate_total_penalty(instance); }
 
+uint32_t Runway::propagate_penalty(const Instance &instance, const size_t position, const Flight &prev_flight,
+                                   uint32_t prev_start_time, uint32_t penalty, const uint32_t bound) const {
+    const Flight *prev = &prev_flight;
+
+    for (size_t k = position; k < sequence.size(); ++k) {
+        if (penalty >= bound) break;
+
+        const Flight &current_flight = sequence[k].get();
+
+        // prev_start_time becomes current_start_time
+        prev_start_time = std::max(current_flight.get_release_time(),
+                                   prev_start_time + prev->get_runway_occupancy_time() +
+                                       instance.get_separation_time(prev->get_id(), current_flight.get_id()));
+
+        if (current_flight.start_time == prev_start_time) {
+            // Nothing gonna change until end
+            return penalty + prefix_penalty[sequence.size()] - prefix_penalty[k];
+        }
+        penalty += (prev_start_time - current_flight.get_release_time()) * current_flight.get_delay_penalty();
+        prev = &current_flight;
+    }
+    return penalty;
+}
+
+uint32_t Runway::replacement_penalty(const Instance &instance, const size_t position, const Flight &flight,
+                                     const uint32_t bound) const {
+    uint32_t start_time = flight.get_release_time();
+
+    if (position > 0) {
+        const Flight &prev_flight = sequence[position - 1].get();
+
+        start_time = std::max(flight.get_release_time(),
+                              prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
+                                  instance.get_separation_time(prev_flight.get_id(), flight.get_id()));
+    }
+    const uint32_t penalty =
+        prefix_penalty[position] + ((start_time - flight.get_release_time()) * flight.get_delay_penalty());
+
+    return propagate_penalty(instance, position + 1, flight, start_time, penalty, bound);
+}
+
+uint32_t Runway::insertion_penalty(const Instance &instance, const size_t position, const Flight &flight) const {
+    uint32_t start_time = flight.get_release_time();
+
+    if (position > 0) {
+        const Flight &prev_flight = sequence[position - 1].get();
+
+        start_time = std::max(flight.get_release_time(),
+                              prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
+                                  instance.get_separation_time(prev_flight.get_id(), flight.get_id()));
+    }
+    const uint32_t penalty =
+        prefix_penalty[position] + ((start_time - flight.get_release_time()) * flight.get_delay_penalty());
+
+    return propagate_penalty(instance, position, flight, start_time, penalty);
+}
+
+uint32_t Runway::removal_penalty(const Instance &instance, const size_t position) const {
+    if (position + 1 == sequence.size()) {
+        return prefix_penalty[position];
+    }
+    if (position == 0) {
+        // The next flight becomes the first one and starts at its release time
+        const Flight &next_flight = sequence[1].get();
+        return propagate_penalty(instance, 2, next_flight, next_flight.get_release_time(), 0);
+    }
+    const Flight &prev_flight = sequence[position - 1].get();
+
+    return propagate_penalty(instance, position + 1, prev_flight, prev_flight.start_time, prefix_penalty[position]);
+}
+
+void Runway::update_schedule(const Instance &instance, size_t position) {
+    prefix_penalty.resize(sequence.size() + 1);
+
+    if (sequence.empty()) {
+        penalty = 0;
+        return;
+    }
+
+    if (position == 0) {
+        Flight &first_flight = sequence.front().get();
+        first_flight.start_time = first_flight.get_release_time();
+        first_flight.runway = m_id;
+        first_flight.position = 0;
+        prefix_penalty[1] = 0;
+        position++;
+    }
+
+    for (size_t i = position; i < sequence.size(); ++i) {
+        Flight &current_flight = sequence[i].get();
+        Flight &prev_flight = sequence[i - 1].get();
+
+        current_flight.start_time =
+            std::max(current_flight.get_release_time(),
+                     prev_flight.start_time + prev_flight.get_runway_occupancy_time() +
+                         instance.get_separation_time(prev_flight.get_id(), current_flight.get_id()));
+        current_flight.runway = m_id;
+        current_flight.position = i;
+
+        prefix_penalty[i + 1] =
+            prefix_penalty[i] +
+            (current_flight.start_time - current_flight.get_release_time()) * current_flight.get_delay_penalty();
+    }
+    penalty = prefix_penalty.back();
+}
+
 bool Runway::test_sequence_feasibility(const Instance &instance) const {
     std::unordered_set<size_t> set;
 
@@ -55,6 +161,50 @@ bool Runway::test_sequence_feasibility(const Instance &instance) const {
 
 bool Runway::test_penalty(const Instance &instance) const { return penalty == calculate_total_penalty(instance); }
 
+uint64_t Runway::link_hash(const size_t position) const {
+    const size_t predecessor = position > 0 ? sequence[position - 1].get().get_id() : NO_PREDECESSOR;
+    return hash_link(predecessor, sequence[position].get().get_id());
+}
+
+uint64_t Runway::neighbors_hash(const size_t position) const {
+    uint64_t hash = link_hash(position);
+
+    if (position + 1 < sequence.size()) {
+        hash ^= link_hash(position + 1);
+    }
+    return hash;
+}
+
+uint64_t Runway::removal_hash(const size_t position) const {
+    uint64_t hash = neighbors_hash(position);
+
+    // The previous and the next flights become linked
+    if (position + 1 < sequence.size()) {
+        const size_t predecessor = position > 0 ? sequence[position - 1].get().get_id() : NO_PREDECESSOR;
+        hash ^= hash_link(predecessor, sequence[position + 1].get().get_id());
+    }
+    return hash;
+}
+
+uint64_t Runway::swap_hash(const size_t position_i, const size_t position_j) const {
+    uint64_t hash = neighbors_hash(position_i) ^ neighbors_hash(position_j);
+
+    // Adjacent flights share a link, which the XOR above cancels out
+    if (position_i + 1 == position_j or position_j + 1 == position_i) {
+        hash ^= link_hash(std::max(position_i, position_j));
+    }
+    return hash;
+}
+
+uint64_t Runway::calculate_hash() const {
+    uint64_t hash = 0;
+
+    for (size_t position = 0; position < sequence.size(); ++position) {
+        hash ^= link_hash(position);
+    }
+    return hash;
+}
+
 bool Runway::test_feasibility(const Instance &instance) const {
     return test_sequence_feasibility(instance) and test_penalty(instance);
 }
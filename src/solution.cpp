@@ -5,7 +5,9 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <unordered_set>
 
 Solution::Solution(const Instance &instance) {
@@ -37,6 +39,79 @@ void Solution::update_objective(const Instance &instance) {
     assert(test_feasibility(instance));
 }
 
+uint64_t Solution::calculate_hash() const {
+    uint64_t calculated_hash = 0;
+    for (const Runway &runway : runways) {
+        calculated_hash ^= runway.calculate_hash();
+    }
+    return calculated_hash;
+}
+
+void Solution::update_hash() { hash = calculate_hash(); }
+
+void Solution::get_sequences(std::vector<std::vector<size_t>> &sequences) const {
+    sequences.resize(runways.size());
+
+    for (size_t i = 0; i < runways.size(); ++i) {
+        sequences[i].clear();
+
+        for (const auto &flight : runways[i].sequence) {
+            sequences[i].push_back(flight.get().get_id());
+        }
+    }
+}
+
+void Solution::write(const std::filesystem::path &solution_file_path) const {
+    std::ofstream file(solution_file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open solution file");
+    }
+
+    file << runways.size() << ' ' << objective << '\n';
+
+    for (const Runway &runway : runways) {
+        file << runway.sequence.size();
+
+        for (const auto &flight : runway.sequence) {
+            file << ' ' << flight.get().get_id() + 1 << ' ' << flight.get().start_time;
+        }
+        file << '\n';
+    }
+}
+
+std::vector<std::vector<size_t>> Solution::read_sequences(const std::filesystem::path &solution_file_path) {
+    std::ifstream file(solution_file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open solution file");
+    }
+
+    size_t num_runways = 0;
+    size_t objective = 0;
+    file >> num_runways >> objective;
+
+    // The counts are not trusted for allocations, the vectors only grow with what is actually read
+    std::vector<std::vector<size_t>> sequences;
+
+    for (size_t runway_i = 0; runway_i < num_runways and file; ++runway_i) {
+        std::vector<size_t> &sequence = sequences.emplace_back();
+        size_t num_flights = 0;
+        file >> num_flights;
+
+        size_t flight = 0;
+        size_t start_time = 0;
+        for (size_t i = 0; i < num_flights and file >> flight >> start_time; ++i) {
+            if (flight == 0) {
+                throw std::runtime_error("Invalid solution file");
+            }
+            sequence.push_back(flight - 1);
+        }
+    }
+    if (file.fail()) {
+        throw std::runtime_error("Invalid solution file");
+    }
+    return sequences;
+}
+
 bool Solution::test_feasibility(const Instance &instance) const {
     if (runways.size() != instance.get_num_runways()) {
         return false;
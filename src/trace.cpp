@@ -0,0 +1,65 @@
+#include "ASP.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+void ASP::start_trace() {
+    m_trace.assign(trace_capacity, TracePoint{});
+    m_trace_points = 0;
+    m_tracing = true;
+    m_next_progress = m_start_time;
+}
+
+void ASP::trace(const size_t ils_iteration, const size_t incumbent) {
+    if (not m_tracing) return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if (not m_trace.empty()) {
+        TracePoint &point = m_trace[m_trace_points % m_trace.size()];
+
+        point.elapsed_ns =
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start_time).count());
+        point.iteration = m_iteration;
+        point.ils_iteration = ils_iteration;
+        point.incumbent = incumbent;
+        point.best = m_best_objective;
+        m_trace_points++;
+    }
+
+    // No flush, the search goes on while the line is written
+    if (progress_interval > 0 and now >= m_next_progress) {
+        std::cout << '[' << std::chrono::duration<double>(now - m_start_time).count() << " s] Iteration " << m_iteration
+                  << ", ILS iteration " << ils_iteration << ": incumbent " << incumbent << ", best "
+                  << m_best_objective << '\n';
+
+        m_next_progress = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(progress_interval));
+    }
+}
+
+void ASP::write_trace(const std::filesystem::path &path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open trace file");
+    }
+
+    file << "elapsed_ns,iteration,ils_iteration,incumbent,best\n";
+
+    // Once the buffer wrapped around, the oldest point is the next one to be overwritten
+    const size_t num_points = std::min(m_trace_points, m_trace.size());
+    const size_t first = m_trace_points - num_points;
+
+    for (size_t i = first; i < m_trace_points; ++i) {
+        const TracePoint &point = m_trace[i % m_trace.size()];
+
+        file << point.elapsed_ns << ',' << point.iteration << ',' << point.ils_iteration << ',' << point.incumbent
+             << ',' << point.best << '\n';
+    }
+}